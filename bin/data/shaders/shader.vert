@@ -1,6 +1,9 @@
+uniform float point_scale;
+
 void main() {
   gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+  // the diameter in world units, carried in the normal's x
   float size = gl_Normal.x;
-  gl_PointSize = size;
+  gl_PointSize = size * point_scale / gl_Position.w;
   gl_FrontColor = gl_Color;
 }
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "asset-loader.h"
+
+/**
+ * @brief Waits for any loads still running
+ */
+AssetLoader::~AssetLoader() {
+  for (auto& worker : workers_) {
+    worker.wait();
+  }
+}
+
+/**
+ * @brief Queues a load to be run by Start()
+ * @param failure_message The message to report if the load fails
+ * @param load The load to run, returning true on success
+ */
+void AssetLoader::Add(const std::string& failure_message,
+                      std::function<bool()> load) {
+  Load queued_load;
+  queued_load.failure_message_ = failure_message;
+  queued_load.load_ = std::move(load);
+
+  loads_.push_back(std::move(queued_load));
+}
+
+/**
+ * @brief Starts every queued load, each on its own worker thread
+ */
+void AssetLoader::Start() {
+  for (auto& load : loads_) {
+    workers_.push_back(std::async(std::launch::async, [this, &load] {
+      load.succeeded_ = load.load_();
+      num_finished_++;
+    }));
+  }
+}
+
+/**
+ * @brief Determines if every load has finished
+ * @return True if every load has finished, successfully or not
+ */
+bool AssetLoader::IsDone() const {
+  return num_finished_ == static_cast<int>(loads_.size());
+}
+
+/**
+ * @brief Gets the fraction of loads that have finished
+ * @return The fraction of loads that have finished, in [0, 1]
+ */
+float AssetLoader::GetProgress() const {
+  if (loads_.empty()) return 1.0f;
+
+  return static_cast<float>(num_finished_) / loads_.size();
+}
+
+/**
+ * @brief Gets the failure messages of the loads that failed
+ * @return The failure messages, which are only complete once IsDone() is true
+ */
+std::vector<std::string> AssetLoader::GetFailures() const {
+  std::vector<std::string> failures;
+
+  if (!IsDone()) return failures;
+
+  for (const auto& load : loads_) {
+    if (!load.succeeded_) failures.push_back(load.failure_message_);
+  }
+
+  return failures;
+}
@@ -0,0 +1,44 @@
+/**
+ * @class AssetLoader
+ * @brief Runs independent asset loads concurrently on worker threads, and
+ * tracks their progress
+ * @details Loads must not touch OpenGL, since they run off the main thread;
+ * anything that needs a GL context should be finished once IsDone() is true.
+ * @author Patrick Silvestre
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+class AssetLoader {
+ public:
+  AssetLoader() = default;
+  ~AssetLoader();
+
+  AssetLoader(const AssetLoader&) = delete;
+  AssetLoader& operator=(const AssetLoader&) = delete;
+
+  void Add(const std::string& failure_message, std::function<bool()> load);
+  void Start();
+
+  bool IsDone() const;
+  float GetProgress() const;
+  std::vector<std::string> GetFailures() const;
+
+ private:
+  class Load {
+   public:
+    std::string failure_message_;
+    std::function<bool()> load_;
+    bool succeeded_ = false;
+  };
+
+  std::atomic<int> num_finished_{0};
+  std::vector<Load> loads_;
+  std::vector<std::future<void>> workers_;
+};
@@ -72,6 +72,22 @@ bool Box::Inside(const std::vector<glm::vec3>& points) const {
  */
 bool Box::Intersect(const Ray& ray, const float z_buffer_min,
                     const float z_buffer_max) const {
+  float distance;
+
+  return Intersect(ray, z_buffer_min, z_buffer_max, distance);
+}
+
+/**
+ * @brief Determines if a ray intersects this Box, and where it enters
+ * @param ray The ray to test
+ * @param z_buffer_min The minimum z-buffer distance for culling
+ * @param z_buffer_max The maximum z-buffer distance for culling
+ * @param distance (SIDE EFFECT RETURN VALUE) The distance along the ray at
+ * which it enters this Box, no less than z_buffer_min
+ * @return True if the ray intersects this Box, false otherwise
+ */
+bool Box::Intersect(const Ray& ray, const float z_buffer_min,
+                    const float z_buffer_max, float& distance) const {
   auto x_min =
       (corners_[ray.sign_[0]].x - ray.origin_.x) * ray.inverse_direction_.x;
   auto x_max =
@@ -96,7 +112,12 @@ bool Box::Intersect(const Ray& ray, const float z_buffer_min,
   if (z_min > x_min) x_min = z_min;
   if (z_max < x_max) x_max = z_max;
 
-  return x_min < z_buffer_max && x_max > z_buffer_min;
+  if (x_min < z_buffer_max && x_max > z_buffer_min) {
+    distance = x_min > z_buffer_min ? x_min : z_buffer_min;
+    return true;
+  }
+
+  return false;
 }
 
 /**
@@ -119,6 +140,171 @@ bool Box::Overlap(const Box& other_box) const {
   return false;
 }
 
+/**
+ * @brief Determines if this Box overlaps with a triangle
+ * @details Separating axis test, as described in Tomas Akenine-Moller "Fast
+ * 3D Triangle-Box Overlap Testing" Journal of graphics tools, 6(1):29-33,
+ * 2001
+ * @param v0 The triangle's first vertex
+ * @param v1 The triangle's second vertex
+ * @param v2 The triangle's third vertex
+ * @return True if this Box overlaps the triangle, false otherwise
+ */
+bool Box::Overlap(const glm::vec3& v0, const glm::vec3& v1,
+                  const glm::vec3& v2) const {
+  const auto center = Center();
+  const auto half_size = (corners_[1] - corners_[0]) / 2.0f;
+  const glm::vec3 vertices[3] = {v0 - center, v1 - center, v2 - center};
+  const glm::vec3 edges[3] = {vertices[1] - vertices[0],
+                              vertices[2] - vertices[1],
+                              vertices[0] - vertices[2]};
+
+  // projects the triangle and this Box onto an axis, and checks for a gap;
+  // like Overlap(const Box&), merely touching does not count as overlapping
+  const auto separated = [&](const glm::vec3& axis) {
+    // edges parallel to a Box axis give a degenerate axis, which separates
+    // nothing
+    if (glm::dot(axis, axis) < 1e-12f) return false;
+
+    const auto p0 = glm::dot(vertices[0], axis);
+    const auto p1 = glm::dot(vertices[1], axis);
+    const auto p2 = glm::dot(vertices[2], axis);
+    const auto radius = half_size.x * abs(axis.x) +
+                        half_size.y * abs(axis.y) +
+                        half_size.z * abs(axis.z);
+
+    return std::min({p0, p1, p2}) >= radius ||
+           std::max({p0, p1, p2}) <= -radius;
+  };
+
+  // this Box's face normals
+  for (auto i = 0; i < 3; i++) {
+    auto axis = glm::vec3(0.0f);
+    axis[i] = 1.0f;
+
+    if (separated(axis)) return false;
+  }
+
+  // the triangle's face normal
+  if (separated(glm::cross(edges[0], edges[1]))) return false;
+
+  // cross products of this Box's edges with the triangle's edges
+  for (const auto& edge : edges) {
+    if (separated(glm::vec3(0.0f, -edge.z, edge.y))) return false;
+    if (separated(glm::vec3(edge.z, 0.0f, -edge.x))) return false;
+    if (separated(glm::vec3(-edge.y, edge.x, 0.0f))) return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Determines when this Box, moving in a straight line, first touches a
+ * triangle
+ * @details The separating axis test of Overlap(), extended to motion: on each
+ * of the same 13 axes, the projections overlap during one interval of time,
+ * and the Box and triangle touch while all of those intervals do. Contact
+ * that already exists at the start of the motion is not reported, unless the
+ * Box is no deeper than kSweepTolerance and moving further in, which counts
+ * as an impact at time 0.
+ * @param displacement How far this Box moves, in total
+ * @param v0 The triangle's first vertex
+ * @param v1 The triangle's second vertex
+ * @param v2 The triangle's third vertex
+ * @param time (SIDE EFFECT RETURN VALUE) The time of impact, as a fraction of
+ * displacement in [0, 1]
+ * @param normal (SIDE EFFECT RETURN VALUE) The unit separating axis the Box
+ * crosses last, facing against the motion
+ * @return True if this Box starts to overlap the triangle during the motion,
+ * false otherwise
+ */
+bool Box::Sweep(const glm::vec3& displacement, const glm::vec3& v0,
+                const glm::vec3& v1, const glm::vec3& v2, float& time,
+                glm::vec3& normal) const {
+  const auto center = Center();
+  const auto half_size = (corners_[1] - corners_[0]) / 2.0f;
+  const glm::vec3 vertices[3] = {v0 - center, v1 - center, v2 - center};
+  const glm::vec3 edges[3] = {vertices[1] - vertices[0],
+                              vertices[2] - vertices[1],
+                              vertices[0] - vertices[2]};
+  auto enter_time = -std::numeric_limits<float>::max();
+  auto exit_time = std::numeric_limits<float>::max();
+  auto enter_axis = glm::vec3(0.0f);
+
+  // narrows [enter_time, exit_time] to when the projections overlap on an
+  // axis; false once that interval is empty
+  const auto overlapping = [&](const glm::vec3& axis) {
+    if (glm::dot(axis, axis) < 1e-12f) return true;
+
+    const auto p0 = glm::dot(vertices[0], axis);
+    const auto p1 = glm::dot(vertices[1], axis);
+    const auto p2 = glm::dot(vertices[2], axis);
+    const auto radius = half_size.x * abs(axis.x) +
+                        half_size.y * abs(axis.y) +
+                        half_size.z * abs(axis.z);
+    const auto min = std::min({p0, p1, p2}) - radius;
+    const auto max = std::max({p0, p1, p2}) + radius;
+    const auto speed = glm::dot(displacement, axis);
+
+    if (speed == 0.0f) return min < 0.0f && max > 0.0f;
+
+    auto axis_enter_time = min / speed;
+    auto axis_exit_time = max / speed;
+
+    if (speed < 0.0f) std::swap(axis_enter_time, axis_exit_time);
+
+    if (axis_enter_time > enter_time) {
+      enter_time = axis_enter_time;
+      enter_axis = axis;
+    }
+
+    if (axis_exit_time < exit_time) exit_time = axis_exit_time;
+
+    return enter_time < exit_time;
+  };
+
+  // this Box's face normals
+  for (auto i = 0; i < 3; i++) {
+    auto axis = glm::vec3(0.0f);
+    axis[i] = 1.0f;
+
+    if (!overlapping(axis)) return false;
+  }
+
+  // the triangle's face normal
+  if (!overlapping(glm::cross(edges[0], edges[1]))) return false;
+
+  // cross products of this Box's edges with the triangle's edges
+  for (const auto& edge : edges) {
+    if (!overlapping(glm::vec3(0.0f, -edge.z, edge.y))) return false;
+    if (!overlapping(glm::vec3(edge.z, 0.0f, -edge.x))) return false;
+    if (!overlapping(glm::vec3(-edge.y, edge.x, 0.0f))) return false;
+  }
+
+  // a negative entry time means they already overlap, or would have before
+  // the motion began; only a barely touching Box still heading in is stopped
+  if (enter_time < 0.0f) {
+    // no axis ever closed in, so the Box overlaps throughout a null motion
+    if (enter_axis == glm::vec3(0.0f)) return false;
+
+    const auto depth = -enter_time * abs(glm::dot(displacement, enter_axis)) /
+                       glm::length(enter_axis);
+
+    if (depth > kSweepTolerance || exit_time <= 0.0f) return false;
+
+    enter_time = 0.0f;
+  }
+
+  if (enter_time > 1.0f) return false;
+
+  time = enter_time;
+  normal = glm::normalize(enter_axis);
+
+  if (glm::dot(normal, displacement) > 0.0f) normal = -normal;
+
+  return true;
+}
+
 /**
  * @brief Creates a bounding Box for a given mesh
  * @param mesh The given mesh to bound
@@ -25,12 +25,24 @@ class Box {
   glm::vec3 Center() const;
   void Draw() const;
   bool Intersect(const Ray& ray, float z_buffer_min, float z_buffer_max) const;
+  bool Intersect(const Ray& ray, float z_buffer_min, float z_buffer_max,
+                 float& distance) const;
   bool Inside(const glm::vec3& point) const;
   bool Inside(const std::vector<glm::vec3>& points) const;
   bool Overlap(const Box& other_box) const;
+  bool Overlap(const glm::vec3& v0, const glm::vec3& v1,
+               const glm::vec3& v2) const;
+  bool Sweep(const glm::vec3& displacement, const glm::vec3& v0,
+             const glm::vec3& v1, const glm::vec3& v2, float& time,
+             glm::vec3& normal) const;
 
   static Box CreateMeshBoundingBox(const ofMesh& mesh);
 
+  // how deep a Box may already overlap a triangle at the start of Sweep() and
+  // still be stopped by it, so rounding cannot let a Box placed against a face
+  // slip through it on the next step
+  static constexpr float kSweepTolerance = 1e-3f;
+
  private:
   glm::vec3 corners_[2] = {glm::vec3(0.0f), glm::vec3(0.0f)};
   // note: corners_[0] = min_corner, corners_[1] = max_corner
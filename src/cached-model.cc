@@ -0,0 +1,342 @@
+#include "cached-model.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include "mapped-file.h"
+
+namespace {
+
+// bump whenever the layout below changes
+constexpr uint32_t kCacheVersion = 1;
+constexpr char kCacheMagic[8] = {'L', 'N', 'D', 'R', 'M', 'S', 'H', '\0'};
+
+// a mesh cache is this header, then for each mesh a MeshHeader followed by
+// its positions, normals, texture coordinates and indices, all as 32-bit
+// values in the native byte order
+struct CacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_meshes;
+  float scene_min[3];
+  float scene_max[3];
+};
+
+struct MeshHeader {
+  uint32_t num_vertices;
+  uint32_t num_normals;
+  uint32_t num_tex_coords;
+  uint32_t num_indices;
+  float ambient[4];
+  float diffuse[4];
+  float specular[4];
+  float emissive[4];
+  float shininess;
+};
+
+void WriteColor(const ofFloatColor& color, float packed[4]) {
+  packed[0] = color.r;
+  packed[1] = color.g;
+  packed[2] = color.b;
+  packed[3] = color.a;
+}
+
+ofFloatColor ReadColor(const float packed[4]) {
+  return ofFloatColor(packed[0], packed[1], packed[2], packed[3]);
+}
+
+// the post-processing ofxAssimpModelLoader::loadModel() asks for, so a cache
+// holds the same meshes the addon would have drawn
+constexpr unsigned int kImportFlags =
+    aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_Triangulate |
+    aiProcess_FlipUVs;
+
+// grows scene_min and scene_max to enclose a node's meshes and its children's,
+// placed by their transformations, as ofxAssimpModelLoader measures a scene
+void GrowSceneBounds(const aiScene& scene, const aiNode& node,
+                     const aiMatrix4x4& parent_transformation,
+                     glm::vec3& scene_min, glm::vec3& scene_max) {
+  const auto transformation = parent_transformation * node.mTransformation;
+
+  for (auto i = 0u; i < node.mNumMeshes; i++) {
+    const auto& mesh = *scene.mMeshes[node.mMeshes[i]];
+
+    for (auto j = 0u; j < mesh.mNumVertices; j++) {
+      const auto vertex = transformation * mesh.mVertices[j];
+      const auto position = glm::vec3(vertex.x, vertex.y, vertex.z);
+      scene_min = glm::min(scene_min, position);
+      scene_max = glm::max(scene_max, position);
+    }
+  }
+
+  for (auto i = 0u; i < node.mNumChildren; i++) {
+    GrowSceneBounds(scene, *node.mChildren[i], transformation, scene_min,
+                    scene_max);
+  }
+}
+
+// copies an Assimp mesh's positions, normals, first texture coordinates and
+// face indices; none of it touches OpenGL
+ofMesh ToMesh(const aiMesh& assimp_mesh) {
+  ofMesh mesh;
+
+  for (auto i = 0u; i < assimp_mesh.mNumVertices; i++) {
+    const auto& vertex = assimp_mesh.mVertices[i];
+    mesh.addVertex(glm::vec3(vertex.x, vertex.y, vertex.z));
+
+    if (assimp_mesh.HasNormals()) {
+      const auto& normal = assimp_mesh.mNormals[i];
+      mesh.addNormal(glm::vec3(normal.x, normal.y, normal.z));
+    }
+
+    if (assimp_mesh.HasTextureCoords(0)) {
+      const auto& tex_coord = assimp_mesh.mTextureCoords[0][i];
+      mesh.addTexCoord(glm::vec2(tex_coord.x, tex_coord.y));
+    }
+  }
+
+  for (auto i = 0u; i < assimp_mesh.mNumFaces; i++) {
+    const auto& face = assimp_mesh.mFaces[i];
+
+    for (auto j = 0u; j < face.mNumIndices; j++) {
+      mesh.addIndex(face.mIndices[j]);
+    }
+  }
+
+  return mesh;
+}
+
+// colours the material does not set keep ofMaterial's defaults
+ofMaterial ToMaterial(const aiMaterial& assimp_material) {
+  ofMaterial material;
+  aiColor4D color;
+  auto shininess = 0.0f;
+
+  if (assimp_material.Get(AI_MATKEY_COLOR_AMBIENT, color) == AI_SUCCESS) {
+    material.setAmbientColor(ofFloatColor(color.r, color.g, color.b, color.a));
+  }
+
+  if (assimp_material.Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS) {
+    material.setDiffuseColor(ofFloatColor(color.r, color.g, color.b, color.a));
+  }
+
+  if (assimp_material.Get(AI_MATKEY_COLOR_SPECULAR, color) == AI_SUCCESS) {
+    material.setSpecularColor(
+        ofFloatColor(color.r, color.g, color.b, color.a));
+  }
+
+  if (assimp_material.Get(AI_MATKEY_COLOR_EMISSIVE, color) == AI_SUCCESS) {
+    material.setEmissiveColor(
+        ofFloatColor(color.r, color.g, color.b, color.a));
+  }
+
+  if (assimp_material.Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS) {
+    material.setShininess(shininess);
+  }
+
+  return material;
+}
+
+// copies count elements out of a mapped cache, advancing the read position;
+// returns false if the cache is too short
+template <typename T>
+bool Read(const char*& data, const char* end, vector<T>& values,
+          const size_t count) {
+  const auto size = count * sizeof(T);
+
+  if (static_cast<size_t>(end - data) < size) return false;
+
+  values.resize(count);
+  if (size > 0) memcpy(values.data(), data, size);
+  data += size;
+
+  return true;
+}
+
+}  // namespace
+
+/**
+ * @brief Loads a model, from its binary cache if the cache is fresh
+ * @details If the cache is missing or older than the model, the model is
+ * first converted with Convert().
+ * @param model_path The path of the source model, relative to the data folder
+ * @return True if the model was loaded, false otherwise
+ */
+bool CachedModel::Load(const string& model_path) {
+  const auto cache_path = GetCachePath(model_path);
+
+  if (!IsCacheFresh(model_path) && !Convert(model_path, cache_path)) {
+    return false;
+  }
+
+  return LoadCache(cache_path);
+}
+
+/**
+ * @brief Draws this CachedModel's meshes with their materials
+ */
+void CachedModel::DrawFaces() const {
+  for (auto i = 0; i < GetNumMeshes(); i++) {
+    materials_[i].begin();
+    meshes_[i].drawFaces();
+    materials_[i].end();
+  }
+}
+
+/**
+ * @brief Converts a model into the binary cache format by parsing it with
+ * Assimp
+ * @details Imports with Assimp directly rather than through
+ * ofxAssimpModelLoader, which uploads to OpenGL as it loads, so a cache can be
+ * built off the main thread or without a window at all.
+ * @param model_path The path of the source model, relative to the data folder
+ * @param cache_path The path of the cache file, which is overwritten
+ * @return True if the cache was written, false otherwise
+ */
+bool CachedModel::Convert(const string& model_path, const string& cache_path) {
+  Assimp::Importer importer;
+  const auto* scene = importer.ReadFile(ofToDataPath(model_path), kImportFlags);
+
+  if (scene == nullptr || scene->mRootNode == nullptr) return false;
+
+  auto scene_min = glm::vec3(std::numeric_limits<float>::max());
+  auto scene_max = glm::vec3(-std::numeric_limits<float>::max());
+  GrowSceneBounds(*scene, *scene->mRootNode, aiMatrix4x4(), scene_min,
+                  scene_max);
+
+  CacheHeader header;
+  memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+  header.version = kCacheVersion;
+  header.num_meshes = scene->mNumMeshes;
+
+  for (auto i = 0; i < 3; i++) {
+    header.scene_min[i] = scene_min[i];
+    header.scene_max[i] = scene_max[i];
+  }
+
+  std::ofstream file(ofToDataPath(cache_path),
+                     std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  for (auto i = 0u; i < header.num_meshes; i++) {
+    const auto& assimp_mesh = *scene->mMeshes[i];
+    const auto mesh = ToMesh(assimp_mesh);
+    const auto material =
+        ToMaterial(*scene->mMaterials[assimp_mesh.mMaterialIndex]);
+    MeshHeader mesh_header;
+    mesh_header.num_vertices = mesh.getNumVertices();
+    mesh_header.num_normals = mesh.getNumNormals();
+    mesh_header.num_tex_coords = mesh.getNumTexCoords();
+    mesh_header.num_indices = mesh.getNumIndices();
+    WriteColor(material.getAmbientColor(), mesh_header.ambient);
+    WriteColor(material.getDiffuseColor(), mesh_header.diffuse);
+    WriteColor(material.getSpecularColor(), mesh_header.specular);
+    WriteColor(material.getEmissiveColor(), mesh_header.emissive);
+    mesh_header.shininess = material.getShininess();
+
+    // ofIndexType is 32-bit outside of OpenGL ES
+    static_assert(sizeof(ofIndexType) == sizeof(uint32_t),
+                  "mesh cache indices are 32-bit");
+
+    file.write(reinterpret_cast<const char*>(&mesh_header),
+               sizeof(mesh_header));
+    file.write(reinterpret_cast<const char*>(mesh.getVertices().data()),
+               mesh_header.num_vertices * sizeof(glm::vec3));
+    file.write(reinterpret_cast<const char*>(mesh.getNormals().data()),
+               mesh_header.num_normals * sizeof(glm::vec3));
+    file.write(reinterpret_cast<const char*>(mesh.getTexCoords().data()),
+               mesh_header.num_tex_coords * sizeof(glm::vec2));
+    file.write(reinterpret_cast<const char*>(mesh.getIndices().data()),
+               mesh_header.num_indices * sizeof(ofIndexType));
+  }
+
+  return file.good();
+}
+
+/**
+ * @brief Gets the path of a model's binary cache
+ * @param model_path The path of the source model
+ * @return The model's path, with its extension replaced by .mesh
+ */
+string CachedModel::GetCachePath(const string& model_path) {
+  const auto extension = model_path.find_last_of('.');
+
+  if (extension == string::npos) return model_path + ".mesh";
+
+  return model_path.substr(0, extension) + ".mesh";
+}
+
+/**
+ * @brief Determines if a model's binary cache exists and is up to date
+ * @param model_path The path of the source model, relative to the data folder
+ * @return True if the cache is at least as new as the model, false otherwise
+ */
+bool CachedModel::IsCacheFresh(const string& model_path) {
+  const auto model_file = ofToDataPath(model_path);
+  const auto cache_file = ofToDataPath(GetCachePath(model_path));
+
+  if (!ofFile::doesFileExist(cache_file, false)) return false;
+
+  // ship-only builds may carry just the cache
+  if (!ofFile::doesFileExist(model_file, false)) return true;
+
+  return std::filesystem::last_write_time(cache_file) >=
+         std::filesystem::last_write_time(model_file);
+}
+
+//-Private Methods----------------------------------------------
+
+bool CachedModel::LoadCache(const string& cache_path) {
+  const MappedFile file(ofToDataPath(cache_path));
+
+  if (!file.IsOpen() || file.get_size() < sizeof(CacheHeader)) return false;
+
+  const auto* data = file.get_data();
+  const auto* end = data + file.get_size();
+  CacheHeader header;
+  memcpy(&header, data, sizeof(header));
+  data += sizeof(header);
+
+  if (memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+      header.version != kCacheVersion) {
+    return false;
+  }
+
+  vector<ofVboMesh> meshes(header.num_meshes);
+  vector<ofMaterial> materials(header.num_meshes);
+
+  for (auto i = 0u; i < header.num_meshes; i++) {
+    if (static_cast<size_t>(end - data) < sizeof(MeshHeader)) return false;
+
+    MeshHeader mesh_header;
+    memcpy(&mesh_header, data, sizeof(mesh_header));
+    data += sizeof(mesh_header);
+
+    auto& mesh = meshes[i];
+    mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+
+    if (!Read(data, end, mesh.getVertices(), mesh_header.num_vertices) ||
+        !Read(data, end, mesh.getNormals(), mesh_header.num_normals) ||
+        !Read(data, end, mesh.getTexCoords(), mesh_header.num_tex_coords) ||
+        !Read(data, end, mesh.getIndices(), mesh_header.num_indices)) {
+      return false;
+    }
+
+    auto& material = materials[i];
+    material.setAmbientColor(ReadColor(mesh_header.ambient));
+    material.setDiffuseColor(ReadColor(mesh_header.diffuse));
+    material.setSpecularColor(ReadColor(mesh_header.specular));
+    material.setEmissiveColor(ReadColor(mesh_header.emissive));
+    material.setShininess(mesh_header.shininess);
+  }
+
+  scene_min_ =
+      glm::vec3(header.scene_min[0], header.scene_min[1], header.scene_min[2]);
+  scene_max_ =
+      glm::vec3(header.scene_max[0], header.scene_max[1], header.scene_max[2]);
+  meshes_ = std::move(meshes);
+  materials_ = std::move(materials);
+
+  return true;
+}
@@ -0,0 +1,39 @@
+/**
+ * @class CachedModel
+ * @brief A static model whose meshes are loaded from a preprocessed binary
+ * cache, falling back to parsing the source model with Assimp
+ * @details The cache packs each mesh's positions, normals, texture
+ * coordinates and indices, plus its material, so that later runs can
+ * memory-map it instead of parsing text. It lives next to the source model
+ * with a .mesh extension, and is rewritten whenever it is older than the
+ * source. Neither converting nor loading touches OpenGL, so both are safe off
+ * the main thread and without a window.
+ * @author Patrick Silvestre
+ */
+
+#pragma once
+
+#include "ofMain.h"
+
+class CachedModel {
+ public:
+  bool Load(const string& model_path);
+  void DrawFaces() const;
+
+  int GetNumMeshes() const { return static_cast<int>(meshes_.size()); }
+  const ofMesh& GetMesh(int mesh) const { return meshes_[mesh]; }
+  glm::vec3 get_scene_min() const { return scene_min_; }
+  glm::vec3 get_scene_max() const { return scene_max_; }
+
+  static bool Convert(const string& model_path, const string& cache_path);
+  static string GetCachePath(const string& model_path);
+  static bool IsCacheFresh(const string& model_path);
+
+ private:
+  bool LoadCache(const string& cache_path);
+
+  glm::vec3 scene_min_ = glm::vec3(0.0f);
+  glm::vec3 scene_max_ = glm::vec3(0.0f);
+  vector<ofVboMesh> meshes_;
+  vector<ofMaterial> materials_;
+};
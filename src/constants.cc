@@ -0,0 +1,7 @@
+#include "constants.h"
+
+namespace constants {
+
+const glm::vec3 kLandingArea = glm::vec3(-10.0f, -10.0f, 40.0f);
+
+};  // namespace constants
@@ -1,3 +1,13 @@
 #pragma once
 
-namespace constants {};  // namespace constants
+#include "ofMain.h"
+
+namespace constants {
+
+// the centre of the pad the Lander must touch down on
+extern const glm::vec3 kLandingArea;
+
+// the fastest the Lander may touch down without crashing
+constexpr float kVelocityThreshold = 4.0f;
+
+};  // namespace constants
@@ -0,0 +1,149 @@
+#include "headless-simulation.h"
+
+#include "cached-model.h"
+#include "constants.h"
+#include "random-stream.h"
+#include "thread-pool.h"
+
+/**
+ * @brief Creates a HeadlessSimulation over the given terrain
+ * @param octree The terrain's Octree, which must outlive this simulation
+ * @param landing_area The centre of the landing area
+ * @param velocity_threshold The fastest the Lander may touch down without
+ * crashing
+ * @param time_step The fixed duration of one simulation step, in seconds
+ */
+HeadlessSimulation::HeadlessSimulation(const Octree& octree,
+                                       const glm::vec3& landing_area,
+                                       float velocity_threshold,
+                                       float time_step)
+    : octree_{octree},
+      landing_area_{landing_area},
+      velocity_threshold_{velocity_threshold},
+      clock_{time_step} {}
+
+/**
+ * @brief Restarts the random turbulence the Lander flies through, so a landing
+ * can be repeated exactly
+ * @param seed The seed shared by every landing of one batch
+ * @param stream Which of the seed's independent streams to use
+ */
+void HeadlessSimulation::Seed(uint64_t seed, uint64_t stream) {
+  lander_system_.Seed(seed, stream);
+}
+
+/**
+ * @brief Flies one landing from a standstill until the Lander touches down or
+ * time runs out
+ * @param start_position Where the Lander starts
+ * @param pilot Applies thrust each step; may be empty for a free fall
+ * @param max_time The simulation time after which the landing is abandoned, in
+ * seconds
+ * @return How and when the landing ended
+ */
+LandingResult HeadlessSimulation::Fly(const glm::vec3& start_position,
+                                      const Pilot& pilot,
+                                      const float max_time) {
+  lander_system_.Reset();
+  lander_system_.set_position(start_position);
+  clock_.Reset();
+
+  LandingResult result;
+
+  while (clock_.GetTime() < max_time) {
+    if (pilot) pilot(lander_system_, clock_.GetTime());
+
+    clock_.Advance(clock_.get_time_step());
+    clock_.Step();
+
+    lander_system_.Update(octree_, clock_.GetFrameTime());
+
+    result.touchdown_ =
+        lander_system_.CheckTouchdown(landing_area_, velocity_threshold_);
+
+    if (result.touchdown_ != Touchdown::kNone) break;
+  }
+
+  result.time_ = clock_.GetTime();
+  result.position_ = lander_system_.get_position();
+  result.velocity_ = lander_system_.get_velocity();
+
+  return result;
+}
+
+/**
+ * @brief Loads the terrain and flies a batch of landings from random starting
+ * points above the landing area, printing a summary to standard output
+ * @details Builds any missing or stale mesh cache itself, as converting a
+ * model needs no OpenGL.
+ * @param num_landings The number of landings to fly
+ * @param seed The random seed, so a batch can be repeated exactly
+ * @return A process exit code
+ */
+int HeadlessSimulation::RunBatch(const int num_landings,
+                                 const unsigned int seed) {
+  // the Lander loads its own model, but would report a failure with a dialog
+  const auto lander_path = string("geo/lander.obj");
+
+  if (!CachedModel::IsCacheFresh(lander_path) &&
+      !CachedModel::Convert(lander_path,
+                            CachedModel::GetCachePath(lander_path))) {
+    cerr << "Lander model missing" << endl;
+    return 1;
+  }
+
+  CachedModel mars;
+
+  if (!mars.Load("geo/mars.obj") || mars.GetNumMeshes() == 0) {
+    cerr << "Mars model missing" << endl;
+    return 1;
+  }
+
+  const auto& mars_mesh = mars.GetMesh(0);
+  Octree octree;
+
+  if (!octree.Load(ofToDataPath("geo/mars.octree"), mars_mesh, 10)) {
+    ThreadPool thread_pool;
+    octree = Octree(mars_mesh, 10, &thread_pool);
+  }
+
+  // stream 0 picks the starting points; landing i flies through stream i + 1
+  RandomStream random(seed);
+  HeadlessSimulation simulation(octree, constants::kLandingArea,
+                                constants::kVelocityThreshold);
+
+  // a simple throttle: fire the main engine whenever descending too fast
+  const auto pilot = [](LanderSystem& lander_system, float) {
+    if (lander_system.get_velocity().y < -2.0f) lander_system.UpwardThrust();
+  };
+
+  auto num_landed = 0;
+  auto num_crashed = 0;
+  auto total_time = 0.0f;
+
+  for (auto i = 0; i < num_landings; i++) {
+    const auto start_position =
+        glm::vec3(constants::kLandingArea.x + random.Uniform(-10.0f, 10.0f),
+                  65.0f,
+                  constants::kLandingArea.z + random.Uniform(-10.0f, 10.0f));
+
+    simulation.Seed(seed, i + 1);
+    const auto result = simulation.Fly(start_position, pilot);
+
+    if (result.touchdown_ == Touchdown::kLanded) num_landed++;
+    if (result.touchdown_ == Touchdown::kCrashed) num_crashed++;
+    total_time += result.time_;
+  }
+
+  const auto num_unfinished = num_landings - num_landed - num_crashed;
+
+  cout << "landings: " << num_landings << " (seed " << seed << ")" << endl
+       << "landed: " << num_landed << endl
+       << "crashed: " << num_crashed << endl
+       << "unfinished: " << num_unfinished << endl
+       << "mean flight time: "
+       << (num_landings > 0 ? total_time / num_landings : 0.0f) << " s"
+       << endl;
+
+  return 0;
+}
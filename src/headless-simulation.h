@@ -0,0 +1,48 @@
+/**
+ * @class HeadlessSimulation
+ * @brief Flies the Lander over the terrain in fixed simulation steps, without a
+ * window or OpenGL, as fast as the CPU allows
+ * @details Used to batch-simulate landings for tuning and testing. Runs are
+ * deterministic for a given random seed, as nothing depends on wall-clock time.
+ * @author Patrick Silvestre
+ */
+
+#pragma once
+
+#include <functional>
+
+#include "lander-system.h"
+#include "octree.h"
+#include "simulation-clock.h"
+
+class LandingResult {
+ public:
+  Touchdown touchdown_ = Touchdown::kNone;  // kNone if time ran out
+  float time_ = 0.0f;
+  glm::vec3 position_ = glm::vec3(0.0f);
+  glm::vec3 velocity_ = glm::vec3(0.0f);
+};
+
+class HeadlessSimulation {
+ public:
+  // called once per step, before the step is taken, to apply any thrust
+  using Pilot = std::function<void(LanderSystem& lander_system, float time)>;
+
+  HeadlessSimulation(const Octree& octree, const glm::vec3& landing_area,
+                     float velocity_threshold,
+                     float time_step = 1.0f / 60.0f);
+
+  void Seed(uint64_t seed, uint64_t stream = 0);
+  LandingResult Fly(const glm::vec3& start_position, const Pilot& pilot,
+                    float max_time = 120.0f);
+
+  static int RunBatch(int num_landings, unsigned int seed);
+
+ private:
+  const Octree& octree_;
+  glm::vec3 landing_area_;
+  float velocity_threshold_;
+
+  SimulationClock clock_;
+  LanderSystem lander_system_;
+};
@@ -1,26 +1,97 @@
 #include "lander-system.h"
 
-LanderSystem::LanderSystem() {
-  particles_.push_back(&lander_);
-  forces_.push_back(&gravity_);
-  forces_.push_back(&turbulence_);
-}
-
 void LanderSystem::Draw() { lander_.Draw(); }
 
-void LanderSystem::Update(const Octree& octree) {
+void LanderSystem::Update(const Octree& octree,
+                          const FrameTime& frame_time) {
   lander_.Update(octree);
 
-  if (lander_.collision_boxes_.size() > 10) {
+  colliding_ = lander_.FindContacts(octree, contacts_) > 0;
+  // judged before the contact response below takes the approach speed away
+  touchdown_velocity_ = lander_.velocity_;
+
+  if (colliding_) {
+    // resolve along the deepest contact: lift the Lander out of the terrain
+    // and cancel whatever motion carries it further in
+    auto deepest = contacts_[0];
+
+    for (const auto& contact : contacts_) {
+      if (contact.depth_ > deepest.depth_) deepest = contact;
+    }
+
+    if (deepest.depth_ > 0.0f) {
+      const auto lift = deepest.normal_ * deepest.depth_;
+      lander_.position_ += lift;
+      lander_.oriented_bounds_.Translate(lift);
+    }
+
+    CancelApproach(deepest.normal_);
+  }
+
+  // sweep the hull's box along this step's motion and stop at the first
+  // impact, so a long step cannot carry the Lander through the terrain. In
+  // contact, the motion has already lost its component into the deepest
+  // contact, and the faces the box rests on are not impacts, so the Lander
+  // can still slide into a slope or wall and be stopped by it
+  const auto start_position = lander_.position_;
+  const auto displacement = lander_.velocity_ * frame_time.time_step_;
+  SweepHit impact;
+  const auto impacted =
+      octree.Sweep(lander_.oriented_bounds_, displacement, impact);
+
+  lander_.Integrate(frame_time.time_step_);
+
+  if (impacted) {
+    // the box can strike terrain between the feet, so count the impact as
+    // a collision in its own right. The box is left a skin short of the face,
+    // so rounding cannot start the next sweep inside it
+    const auto impact_offset =
+        displacement * impact.time_ + impact.normal_ * kImpactSkin;
+
     colliding_ = true;
+    lander_.position_ = start_position + impact_offset;
+    CancelApproach(impact.normal_);
+
+    // the rest of the step slides along the face rather than stopping dead,
+    // so a glancing touch does not stick; the slide is swept in turn, and
+    // stops at whatever it strikes, so it cannot pass through a neighbouring
+    // face either
+    const auto remaining = displacement * (1.0f - impact.time_);
+    const auto slide =
+        remaining -
+        std::min(glm::dot(remaining, impact.normal_), 0.0f) * impact.normal_;
+    auto slide_start = lander_.oriented_bounds_;
+    slide_start.Translate(impact_offset);
+    SweepHit slide_impact;
+
+    if (octree.Sweep(slide_start, slide, slide_impact)) {
+      lander_.position_ +=
+          slide * slide_impact.time_ + slide_impact.normal_ * kImpactSkin;
+      CancelApproach(slide_impact.normal_);
+    } else {
+      lander_.position_ += slide;
+    }
+  }
 
-    // assumption: relatively perfect elastic collision
-    lander_.positional_forces_ += -lander_.velocity_;
-  } else {
-    colliding_ = false;
+  // forces accumulate for the next step's integration
+  gravity_.Update(&lander_.positional_forces_, 1);
+  turbulence_.Update(&lander_.positional_forces_, 1);
+}
+
+Touchdown LanderSystem::CheckTouchdown(const glm::vec3& landing_area,
+                                       float velocity_threshold) const {
+  if (!colliding_) return Touchdown::kNone;
+
+  if (glm::length(touchdown_velocity_) >= velocity_threshold) {
+    return Touchdown::kCrashed;
   }
 
-  ParticleSystem::Update();
+  // a gentle touchdown away from the landing area is neither a win nor a loss
+  if (glm::length(landing_area - lander_.position_) < kLandingRadius) {
+    return Touchdown::kLanded;
+  }
+
+  return Touchdown::kNone;
 }
 
 void LanderSystem::ForwardThrust() {
@@ -61,6 +132,17 @@ void LanderSystem::YawRight() {
   lander_.rotational_forces_ -= lander_.initial_angular_acceleration_;
 }
 
+void LanderSystem::CancelApproach(const glm::vec3& normal) {
+  const auto approach_velocity = glm::dot(lander_.velocity_, normal);
+  const auto approach_acceleration = glm::dot(lander_.acceleration_, normal);
+
+  if (approach_velocity < 0.0f) lander_.velocity_ -= approach_velocity * normal;
+
+  if (approach_acceleration < 0.0f) {
+    lander_.acceleration_ -= approach_acceleration * normal;
+  }
+}
+
 void LanderSystem::Reset() {
   lander_.angular_acceleration_ = 0.0f;
   lander_.angular_velocity_ = 0.0f;
@@ -71,6 +153,14 @@ void LanderSystem::Reset() {
   lander_.positional_forces_ = glm::vec3(0.0f);
   lander_.velocity_ = glm::vec3(0.0f);
 
+  colliding_ = false;
+  contacts_.clear();
+  touchdown_velocity_ = glm::vec3(0.0f);
+
   lander_.altimeter_enabled_ = false;
   lander_.selected_ = false;
-}
\ No newline at end of file
+}
+
+void LanderSystem::Seed(uint64_t seed, uint64_t stream) {
+  turbulence_.random_.Seed(seed, stream);
+}
@@ -1,21 +1,25 @@
 /**
  * @class LanderSystem
- * @brief Encapsulates a LanderSystem, which is a ParticleSystem to hold one
- * Lander and its associated ParticleForces
+ * @brief Encapsulates a LanderSystem, which holds one Lander and its
+ * associated ParticleForces
  * @author Patrick Silvestre
  */
 
 #pragma once
 
 #include "lander.h"
-#include "particle-system.h"
+#include "particle-force.h"
+#include "simulation-clock.h"
 
-class LanderSystem : public ParticleSystem {
- public:
-  LanderSystem();
+// the result of the Lander touching the terrain
+enum class Touchdown { kNone, kLanded, kCrashed };
 
+class LanderSystem {
+ public:
   void Draw();
-  void Update(const Octree& octree);
+  void Update(const Octree& octree, const FrameTime& frame_time);
+  Touchdown CheckTouchdown(const glm::vec3& landing_area,
+                           float velocity_threshold) const;
 
   // Particle setters, getters
   float get_orientation() const { return lander_.orientation_; }
@@ -33,6 +37,7 @@ class LanderSystem : public ParticleSystem {
   Box get_bounds() const { return lander_.bounds_; }
 
   bool is_colliding() const { return colliding_; }
+  const vector<Contact>& get_contacts() const { return contacts_; }
 
   void ForwardThrust();
   void LeftwardThrust();
@@ -43,9 +48,21 @@ class LanderSystem : public ParticleSystem {
   void YawRight();
 
   void Reset();
+  void Seed(uint64_t seed, uint64_t stream = 0);
 
  private:
+  void CancelApproach(const glm::vec3& normal);
+
+  // how close to the landing area's centre a landing must be to count
+  static constexpr float kLandingRadius = 5.0f;
+
+  // how far the hull is left from a face it strikes; more than
+  // Box::kSweepTolerance, so sliding along the face does not strike it again
+  static constexpr float kImpactSkin = 0.01f;
+
   bool colliding_ = false;
+  vector<Contact> contacts_;
+  glm::vec3 touchdown_velocity_ = glm::vec3(0.0f);
 
   Lander lander_;
   GravityForce gravity_ = GravityForce(glm::vec3(0.0f, -0.1f, 0.0f));
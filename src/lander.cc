@@ -1,15 +1,13 @@
 #include "lander.h"
 
 Lander::Lander() {
-  if (model_.loadModel("geo/lander.obj")) {
+  if (model_.Load("geo/lander.obj")) {
     lifespan_ = -1.0f;
 
-    model_.setScaleNormalization(false);
-    model_.setPosition(position_.x, position_.y, position_.z);
     position_ = glm::vec3(-45.0f, 65.0f, -45.0f);
 
-    bounds_ =
-        Box(model_.getSceneMin() + position_, model_.getSceneMax() + position_);
+    bounds_ = Box(model_.get_scene_min() + position_,
+                  model_.get_scene_max() + position_);
   } else {
     ofSystemAlertDialog("Lander model missing. Exiting...");
     ofExit();
@@ -17,41 +15,105 @@ Lander::Lander() {
 }
 
 void Lander::Update(const Octree& octree) {
-  bounds_ =
-      Box(model_.getSceneMin() + position_, model_.getSceneMax() + position_);
-
   transformation_matrix_ = glm::translate(glm::mat4(1.0f), position_);
   transformation_matrix_ =
       glm::rotate(transformation_matrix_, glm::radians(orientation_),
                   glm::vec3(0.0f, 1.0f, 0.0f));
 
+  oriented_bounds_ =
+      OrientedBox(Box(model_.get_scene_min(), model_.get_scene_max()),
+                  transformation_matrix_);
+  bounds_ = oriented_bounds_.get_bounds();
+
+  // only kept for drawing; clear() keeps the buffer's capacity between frames
   collision_boxes_.clear();
-  octree.Intersect(bounds_, octree.root_, collision_boxes_);
+  if (selected_) octree.Intersect(oriented_bounds_, collision_boxes_);
 
   if (altimeter_enabled_) {
-    const auto ray_origin = position_;
+    // sample the terrain under the centre and the corners of the footprint,
+    // and report the nearest, so the reading is the lander's clearance
+    const auto min_corner = bounds_.get_min_corner();
+    const auto max_corner = bounds_.get_max_corner();
     const auto ray_direction = glm::vec3(0.0f, -1.0f, 0.0f);
-    const auto lander_ray = Ray(ray_origin, ray_direction);
-    const auto point_selected =
-        octree.Intersect(lander_ray, octree.root_, selected_node_);
-
-    if (point_selected) {
-      altitude_ = glm::length(position_ - terrain_point_);
-      terrain_point_selected_ = true;
-      terrain_point_ = octree.mesh_.getVertex(selected_node_.points_[0]);
-    } else {
-      altitude_ = -1.0f;
-      terrain_point_selected_ = false;
-      terrain_point_ = glm::vec3(-10000.0f);
+
+    altimeter_rays_.clear();
+    altimeter_rays_.emplace_back(position_, ray_direction);
+    altimeter_rays_.emplace_back(
+        glm::vec3(min_corner.x, position_.y, min_corner.z), ray_direction);
+    altimeter_rays_.emplace_back(
+        glm::vec3(min_corner.x, position_.y, max_corner.z), ray_direction);
+    altimeter_rays_.emplace_back(
+        glm::vec3(max_corner.x, position_.y, min_corner.z), ray_direction);
+    altimeter_rays_.emplace_back(
+        glm::vec3(max_corner.x, position_.y, max_corner.z), ray_direction);
+
+    altitude_ = -1.0f;
+    terrain_point_selected_ = false;
+    terrain_point_ = glm::vec3(-10000.0f);
+
+    if (octree.Intersect(altimeter_rays_, altimeter_hits_) > 0) {
+      for (const auto& terrain_hit : altimeter_hits_) {
+        if (terrain_hit.face_ < 0) continue;
+
+        if (!terrain_point_selected_ || terrain_hit.distance_ < altitude_) {
+          altitude_ = terrain_hit.distance_;
+          terrain_point_selected_ = true;
+          terrain_point_ = terrain_hit.point_;
+        }
+      }
     }
   }
 }
 
+int Lander::FindContacts(const Octree& octree, vector<Contact>& contacts) {
+  // probe down from the top of the model to just below each foot, so a foot
+  // buried up to the model's full height is still found
+  const auto probe_height =
+      model_.get_scene_max().y - model_.get_scene_min().y;
+  const auto ray_direction = glm::vec3(0.0f, -1.0f, 0.0f);
+  glm::vec3 feet[kNumFeet];
+  GetFeet(feet);
+
+  contact_rays_.clear();
+
+  for (const auto& foot : feet) {
+    contact_rays_.emplace_back(foot - ray_direction * probe_height,
+                               ray_direction);
+  }
+
+  contacts.clear();
+
+  if (octree.Intersect(contact_rays_, contact_hits_,
+                       probe_height + kContactSkin) == 0) {
+    return 0;
+  }
+
+  for (const auto& terrain_hit : contact_hits_) {
+    if (terrain_hit.face_ < 0) continue;
+
+    glm::vec3 v0, v1, v2;
+    octree.GetFace(terrain_hit.face_, v0, v1, v2);
+    auto normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
+
+    if (normal.y < 0.0f) normal = -normal;
+
+    Contact contact;
+    contact.point_ = terrain_hit.point_;
+    contact.normal_ = normal;
+    // the probe measures depth vertically; project it onto the normal
+    contact.depth_ = (probe_height - terrain_hit.distance_) * normal.y;
+    contact.face_ = terrain_hit.face_;
+    contacts.push_back(contact);
+  }
+
+  return contacts.size();
+}
+
 void Lander::Draw() {
   ofPushMatrix();
   ofMultMatrix(transformation_matrix_);
 
-  model_.drawFaces();
+  model_.DrawFaces();
 
   ofPopMatrix();
 
@@ -63,7 +125,7 @@ void Lander::Draw() {
 
 void Lander::DrawBounds() const {
   ofSetColor(ofColor::white);
-  bounds_.Draw();
+  oriented_bounds_.Draw();
 }
 
 void Lander::DrawCollisionBoxes() const {
@@ -76,3 +138,17 @@ void Lander::DrawCollisionBoxes() const {
 
   ofFill();
 }
+
+void Lander::GetFeet(glm::vec3 feet[kNumFeet]) const {
+  const auto min = model_.get_scene_min();
+  const auto max = model_.get_scene_max();
+  const glm::vec3 local_feet[kNumFeet] = {
+      glm::vec3(min.x, min.y, min.z), glm::vec3(min.x, min.y, max.z),
+      glm::vec3(max.x, min.y, min.z), glm::vec3(max.x, min.y, max.z),
+      glm::vec3((min.x + max.x) / 2, min.y, (min.z + max.z) / 2)};
+
+  for (auto i = 0; i < kNumFeet; i++) {
+    feet[i] = position_ +
+              glm::rotateY(local_feet[i], glm::radians(orientation_));
+  }
+}
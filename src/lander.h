@@ -8,12 +8,22 @@
 #pragma once
 
 #include "box.h"
+#include "cached-model.h"
 #include "octree.h"
-#include "ofxAssimpModelLoader.h"
+#include "oriented-box.h"
 #include "particle.h"
 
 class Octree;
 
+// where one of the Lander's feet touches or sinks into the terrain
+class Contact {
+ public:
+  glm::vec3 point_ = glm::vec3(0.0f);   // on the terrain
+  glm::vec3 normal_ = glm::vec3(0.0f);  // of the terrain, pointing up
+  float depth_ = 0.0f;  // penetration along normal_; negative if just above
+  int face_ = -1;
+};
+
 class Lander : public Particle {
  public:
   Lander();
@@ -22,15 +32,33 @@ class Lander : public Particle {
   void Draw();
   void DrawBounds() const;
   void DrawCollisionBoxes() const;
+  int FindContacts(const Octree& octree, vector<Contact>& contacts);
 
   bool altimeter_enabled_ = false;
   bool selected_ = false;
   bool terrain_point_selected_ = false;
   float altitude_ = 0.0f;
 
-  ofxAssimpModelLoader model_;
+  CachedModel model_;
   glm::vec3 terrain_point_;
-  Box bounds_;
+  Box bounds_;  // encloses oriented_bounds_
+  OrientedBox oriented_bounds_;
   vector<Box> collision_boxes_;
-  TreeNode selected_node_;
+
+  // the bottom corners and centre of the model's bounds
+  static constexpr int kNumFeet = 5;
+
+  // how far above the terrain a foot still counts as touching it, so resting
+  // contact does not flicker on and off between steps
+  static constexpr float kContactSkin = 0.05f;
+
+ private:
+  void GetFeet(glm::vec3 feet[kNumFeet]) const;
+
+  // reused every frame, so neither the altimeter nor contact generation
+  // allocates anything
+  vector<Ray> altimeter_rays_;
+  vector<RayHit> altimeter_hits_;
+  vector<Ray> contact_rays_;
+  vector<RayHit> contact_hits_;
 };
@@ -1,11 +1,27 @@
+#include "headless-simulation.h"
 #include "ofApp.h"
 #include "ofMain.h"
 
 //========================================================================
-int main() {
+int main(int argc, char* argv[]) {
+  // --headless [num_landings] [seed] batch-simulates landings without a window
+  if (argc > 1 && string(argv[1]) == "--headless") {
+    const auto num_landings = argc > 2 ? atoi(argv[2]) : 1000;
+    const auto seed = argc > 3 ? static_cast<unsigned int>(atol(argv[3])) : 0u;
+
+    ofInit();
+    return HeadlessSimulation::RunBatch(num_landings, seed);
+  }
+
   // tested on 2560x1440 TODO update GUI to fit any screen size
+#ifdef _WIN32
   ofSetupOpenGL(GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN),
                 OF_GAME_MODE);
+#else
+  // GetSystemMetrics() is Win32-only; elsewhere fullscreen picks the screen's
+  // own size
+  ofSetupOpenGL(2560, 1440, OF_FULLSCREEN);
+#endif
 
   ofRunApp(new ofApp());
 }
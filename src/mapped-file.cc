@@ -0,0 +1,85 @@
+#include "mapped-file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Maps a file into memory
+ * @details If the file is missing, empty or cannot be mapped, this MappedFile
+ * is left closed; check IsOpen() before use.
+ * @param path The path of the file to map
+ */
+MappedFile::MappedFile(const std::string& path) {
+#ifdef _WIN32
+  file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_ == INVALID_HANDLE_VALUE) {
+    file_ = nullptr;
+    return;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+    Close();
+    return;
+  }
+
+  mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping_ == nullptr) {
+    Close();
+    return;
+  }
+
+  data_ = static_cast<const char*>(
+      MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+  size_ = data_ != nullptr ? static_cast<std::size_t>(size.QuadPart) : 0;
+
+  if (data_ == nullptr) Close();
+#else
+  const auto file = open(path.c_str(), O_RDONLY);
+  if (file < 0) return;
+
+  struct stat status;
+  if (fstat(file, &status) == 0 && status.st_size > 0) {
+    auto* data =
+        mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    if (data != MAP_FAILED) {
+      data_ = static_cast<const char*>(data);
+      size_ = status.st_size;
+    }
+  }
+
+  // the mapping stays valid after its file descriptor is closed
+  close(file);
+#endif
+}
+
+/**
+ * @brief Unmaps this MappedFile
+ */
+MappedFile::~MappedFile() { Close(); }
+
+//-Private Methods----------------------------------------------
+
+void MappedFile::Close() {
+#ifdef _WIN32
+  if (data_ != nullptr) UnmapViewOfFile(data_);
+  if (mapping_ != nullptr) CloseHandle(mapping_);
+  if (file_ != nullptr) CloseHandle(file_);
+
+  mapping_ = nullptr;
+  file_ = nullptr;
+#else
+  if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+#endif
+
+  data_ = nullptr;
+  size_ = 0;
+}
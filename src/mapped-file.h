@@ -0,0 +1,36 @@
+/**
+ * @class MappedFile
+ * @brief A read-only view of a whole file, memory-mapped so that its contents
+ * are paged in on demand rather than read up front
+ * @author Patrick Silvestre
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+class MappedFile {
+ public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool IsOpen() const { return data_ != nullptr; }
+  const char* get_data() const { return data_; }
+  std::size_t get_size() const { return size_; }
+
+ private:
+  void Close();
+
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+
+#ifdef _WIN32
+  void* file_ = nullptr;
+  void* mapping_ = nullptr;
+#endif
+};
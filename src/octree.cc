@@ -1,20 +1,115 @@
 #include "octree.h"
 
+#include "mapped-file.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+// bump whenever TreeNode or the layout below changes
+constexpr uint32_t kCacheVersion = 1;
+constexpr char kCacheMagic[8] = {'L', 'N', 'D', 'R', 'O', 'C', 'T', '\0'};
+
+// an Octree cache is this header, then num_nodes TreeNodes, then
+// num_face_indices ints, all in the native byte order
+struct CacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_levels;
+  uint64_t mesh_hash;
+  uint64_t num_nodes;
+  uint64_t num_face_indices;
+};
+
+static_assert(std::is_trivially_copyable<TreeNode>::value,
+              "TreeNode must be trivially copyable to be cached");
+static_assert(Octree::kMaxPacketSize <= 32,
+              "a ray packet's active rays must fit in a uint32_t mask");
+
+// the index of the lowest set bit of a nonzero mask
+inline int CountTrailingZeros(uint32_t mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+
+// pushes a node's children onto a front-to-back traversal stack farthest
+// first, so the nearest is popped next; key is the member ordering them, and
+// children is sorted in place, by insertion as there are at most eight
+template <typename StackEntry>
+void PushChildrenFarthestFirst(StackEntry* children, const int num_children,
+                               float StackEntry::*key, StackEntry* stack,
+                               int& stack_size) {
+  for (auto i = 1; i < num_children; i++) {
+    const auto child = children[i];
+    auto j = i;
+
+    for (; j > 0 && children[j - 1].*key < child.*key; j--) {
+      children[j] = children[j - 1];
+    }
+
+    children[j] = child;
+  }
+
+  for (auto i = 0; i < num_children; i++) {
+    stack[stack_size++] = children[i];
+  }
+}
+
+}  // namespace
+
 /**
  * @brief Creates an Octree
- * @param mesh The desired mesh to spatially partition
- * @param num_levels The total number of Octree level divisions
+ * @param mesh The desired mesh to spatially partition, whose faces are
+ * triangles
+ * @param num_levels The total number of Octree level divisions, at most
+ * kMaxLevels
+ * @param thread_pool (OPTIONAL) The ThreadPool used to build the subtrees
+ * below the root concurrently; if null, this Octree is built on the calling
+ * thread
  */
-Octree::Octree(const ofMesh& mesh, const int num_levels) : mesh_{mesh} {
-  root_.box_ = Box::CreateMeshBoundingBox(mesh);
-  auto level = 0;
+Octree::Octree(const ofMesh& mesh, int num_levels, ThreadPool* thread_pool)
+    : mesh_{mesh} {
+  // bounds the depth of the ray query's fixed-size traversal stack
+  if (num_levels > kMaxLevels) num_levels = kMaxLevels;
+  num_levels_ = num_levels;
+
+  const auto num_faces = GetNumFaces();
+  face_indices_.resize(num_faces);
+  vector<glm::vec3> centroids(num_faces);
+
+  for (auto i = 0; i < num_faces; i++) {
+    glm::vec3 v0, v1, v2;
+    GetFace(i, v0, v1, v2);
+
+    face_indices_[i] = i;
+    centroids[i] = (v0 + v1 + v2) / 3.0f;
+  }
+
+  nodes_.emplace_back();
+  nodes_[kRootNode].box_ = Box::CreateMeshBoundingBox(mesh);
+  nodes_[kRootNode].num_faces_ = num_faces;
 
-  for (auto i = 0; i < mesh.getNumVertices(); i++) {
-    root_.points_.push_back(i);
+  // scratch octant codes, parallel to face_indices_
+  vector<unsigned char> octants(num_faces);
+
+  if (thread_pool != nullptr) {
+    SubdivideParallel(centroids, octants, num_levels, *thread_pool);
+  } else {
+    auto level = 0;
+    level++;
+    Subdivide(centroids, nodes_, face_indices_, octants, kRootNode, num_levels,
+              level);
   }
 
-  level++;
-  Subdivide(mesh, root_, num_levels, level);
+  RefitBoxes();
+  BuildChildBoxes();
 }
 
 /**
@@ -23,151 +118,800 @@ Octree::Octree(const ofMesh& mesh, const int num_levels) : mesh_{mesh} {
  * @param current_level The current Octree level division
  */
 void Octree::Draw(const int num_levels, const int current_level) const {
-  Draw(root_, num_levels, current_level);
+  Draw(kRootNode, num_levels, current_level);
 }
 
 /**
  * @brief Determines which leaf nodes in this Octree are intersected by a given
  * Box
  * @param box The Box potentially intersecting this Octree
- * @param current_node The current node being checked for intersection, which
- * may or may not have children nodes
  * @param terrain_collision_boxes (SIDE EFFECT RETURN VALUE) The final,
- * intersected leaf nodes
- * @return True if the Box intersects this Octree, false otherwise
+ * intersected leaf nodes, appended to whatever the caller's buffer holds
+ * @return True if the Box intersects any leaf node, false otherwise
+ */
+bool Octree::Intersect(const Box& box,
+                       vector<Box>& terrain_collision_boxes) const {
+  return VisitIntersections(box, [&](const TreeNode& leaf) {
+           terrain_collision_boxes.push_back(leaf.box_);
+         }) > 0;
+}
+
+/**
+ * @brief Determines which mesh faces are intersected by a given Box
+ * @param box The Box potentially intersecting this Octree
+ * @param terrain_collision_faces (SIDE EFFECT RETURN VALUE) The indices of
+ * the faces that overlap the Box
+ * @return True if the Box intersects at least one face, false otherwise
+ */
+bool Octree::Intersect(const Box& box,
+                       vector<int>& terrain_collision_faces) const {
+  const auto num_collisions = terrain_collision_faces.size();
+
+  VisitIntersections(box, [&](const TreeNode& leaf) {
+    for (auto i = 0; i < leaf.num_faces_; i++) {
+      const auto face = face_indices_[leaf.first_face_ + i];
+      glm::vec3 v0, v1, v2;
+      GetFace(face, v0, v1, v2);
+
+      if (box.Overlap(v0, v1, v2)) {
+        terrain_collision_faces.push_back(face);
+      }
+    }
+  });
+
+  return terrain_collision_faces.size() > num_collisions;
+}
+
+/**
+ * @brief Determines which leaf nodes in this Octree are intersected by a given
+ * OrientedBox
+ * @param box The OrientedBox potentially intersecting this Octree
+ * @param terrain_collision_boxes (SIDE EFFECT RETURN VALUE) The final,
+ * intersected leaf nodes, appended to whatever the caller's buffer holds
+ * @return True if the OrientedBox intersects any leaf node, false otherwise
  */
-bool Octree::Intersect(const Box& box, const TreeNode& current_node,
+bool Octree::Intersect(const OrientedBox& box,
                        vector<Box>& terrain_collision_boxes) const {
-  if (current_node.box_.Overlap(box)) {
-    if (current_node.children_nodes_.empty()) {
-      terrain_collision_boxes.push_back(current_node.box_);
+  return VisitIntersections(box, [&](const TreeNode& leaf) {
+           terrain_collision_boxes.push_back(leaf.box_);
+         }) > 0;
+}
+
+/**
+ * @brief Finds the nearest mesh face hit by a given ray
+ * @details Traverses front to back: each node's children are visited in order
+ * of where the ray enters them, and any node entered beyond the nearest hit
+ * found so far is skipped, so the walk ends soon after the first confirmed
+ * hit. Nothing is copied or allocated.
+ * @param ray The ray potentially intersecting this Octree
+ * @param hit (SIDE EFFECT RETURN VALUE) The nearest hit, if any
+ * @param max_distance (OPTIONAL) The farthest distance along the ray to
+ * consider
+ * @return True if the ray hits a face within max_distance, false otherwise
+ */
+bool Octree::Intersect(const Ray& ray, RayHit& hit,
+                       const float max_distance) const {
+  hit.distance_ = max_distance;
+  hit.face_ = -1;
+
+  float root_distance;
+
+  if (nodes_.empty() ||
+      !nodes_[kRootNode].box_.Intersect(ray, 0, max_distance, root_distance)) {
+    return false;
+  }
+
+  struct StackEntry {
+    int node_index;
+    float distance;
+  };
+  StackEntry stack[kStackSize];
+  auto stack_size = 0;
+  stack[stack_size++] = {kRootNode, root_distance};
+
+  while (stack_size > 0) {
+    const auto entry = stack[--stack_size];
+
+    if (entry.distance >= hit.distance_) continue;
+
+    const auto& node = nodes_[entry.node_index];
+
+    if (node.IsLeaf()) {
+      IntersectFaces(ray, node, hit);
+      continue;
     }
 
-    for (const auto& child : current_node.children_nodes_) {
-      Intersect(box, child, terrain_collision_boxes);
+    // test all the children at once, then push the ones hit farthest first,
+    // so the nearest is popped next
+    float distances[PackedBoxes::kSize];
+    auto mask = child_boxes_[child_boxes_index_[entry.node_index]].Intersect(
+        ray, 0, hit.distance_, distances);
+    StackEntry children[PackedBoxes::kSize];
+    auto num_hit_children = 0;
+
+    for (auto i = 0; mask != 0; i++, mask >>= 1) {
+      if ((mask & 1) == 0) continue;
+
+      children[num_hit_children++] = {node.first_child_ + i, distances[i]};
     }
 
-    return true;
+    PushChildrenFarthestFirst(children, num_hit_children,
+                              &StackEntry::distance, stack, stack_size);
   }
 
-  return false;
+  if (hit.face_ < 0) return false;
+
+  hit.point_ = ray.origin_ + ray.direction_ * hit.distance_;
+
+  return true;
 }
 
 /**
- * @brief Determines which leaf node in this Octree is intersected by a given
- * ray
- * @param ray The ray potentially intersecting this Octree
- * @param current_node The current node being checked for intersection, which
- * may or may not have children nodes
- * @param collision_node (SIDE EFFECT RETURN VALUE) The final, intersected leaf
- * node
- * @return True if the ray intersects the Octree, false otherwise
+ * @brief Finds the nearest mesh face hit by each of several rays
+ * @details Rays are traced in packets of up to kMaxPacketSize, each packet
+ * walking the tree once: a node is visited if any ray in the packet enters
+ * it, and only those rays are tested against its children or faces. Packets
+ * are visited front to back by their nearest ray, so this is fastest for
+ * coherent rays, such as ones fired from nearby origins in similar
+ * directions.
+ * @param rays The rays potentially intersecting this Octree
+ * @param hits (SIDE EFFECT RETURN VALUE) The nearest hit of each ray, in the
+ * same order as rays; a ray that hits nothing has a negative face_
+ * @param max_distance (OPTIONAL) The farthest distance along each ray to
+ * consider
+ * @return The number of rays that hit a face within max_distance
  */
-bool Octree::Intersect(const Ray& ray, const TreeNode& current_node,
-                       TreeNode& collision_node) const {
-  if (current_node.box_.Intersect(ray, 0, 10000)) {
-    if (current_node.children_nodes_.empty()) {
-      collision_node = current_node;
+int Octree::Intersect(const vector<Ray>& rays, vector<RayHit>& hits,
+                      const float max_distance) const {
+  const int num_rays = rays.size();
+  hits.assign(num_rays, RayHit());
+
+  for (auto& hit : hits) hit.distance_ = max_distance;
+
+  if (nodes_.empty()) return 0;
+
+  for (auto i = 0; i < num_rays; i += kMaxPacketSize) {
+    IntersectPacket(rays.data() + i, hits.data() + i,
+                    std::min(num_rays - i, static_cast<int>(kMaxPacketSize)));
+  }
+
+  auto num_hits = 0;
+
+  for (auto i = 0; i < num_rays; i++) {
+    if (hits[i].face_ < 0) continue;
+
+    hits[i].point_ = rays[i].origin_ + rays[i].direction_ * hits[i].distance_;
+    num_hits++;
+  }
+
+  return num_hits;
+}
+
+/**
+ * @brief Counts the leaf nodes in this Octree intersected by a given Box
+ * @param box The Box potentially intersecting this Octree
+ * @param max_count (OPTIONAL) The count at which to stop early, for callers
+ * that only compare against a threshold; if negative, counts every leaf
+ * @return The number of intersected leaf nodes, at most max_count
+ */
+int Octree::CountIntersections(const Box& box, const int max_count) const {
+  return VisitIntersections(box, [](const TreeNode&) {}, max_count);
+}
+
+/**
+ * @brief Finds the first mesh face an OrientedBox touches while moving in a
+ * straight line, so fast motion cannot tunnel through thin terrain between
+ * steps
+ * @details Nodes are culled and ordered with a SweptOrientedBox, so a turned
+ * box only visits the nodes its motion can actually reach; they are walked
+ * front to back by entry time, as in the ray query, and leaf faces are tested
+ * with OrientedBox::Sweep(). Faces the box already overlaps at the start are
+ * ignored, since those are resting contacts rather than impacts, unless it is
+ * within Box::kSweepTolerance of them and still moving in.
+ * @param box The box at the start of the motion, which does not turn
+ * @param displacement How far the box moves, in total
+ * @param hit (SIDE EFFECT RETURN VALUE) The earliest impact, if any
+ * @return True if the box hits a face before the end of the motion, false
+ * otherwise
+ */
+bool Octree::Sweep(const OrientedBox& box, const glm::vec3& displacement,
+                   SweepHit& hit) const {
+  hit.time_ = 1.0f;
+  hit.face_ = -1;
+
+  if (nodes_.empty() || displacement == glm::vec3(0.0f)) return false;
+
+  const auto swept_box = SweptOrientedBox(box, displacement);
+  float root_time;
+
+  if (!swept_box.Intersect(nodes_[kRootNode].box_, root_time)) return false;
+
+  struct StackEntry {
+    int node_index;
+    float time;
+  };
+  StackEntry stack[kStackSize];
+  auto stack_size = 0;
+  stack[stack_size++] = {kRootNode, root_time};
+
+  while (stack_size > 0) {
+    const auto entry = stack[--stack_size];
+
+    if (entry.time >= hit.time_) continue;
+
+    const auto& node = nodes_[entry.node_index];
+
+    if (node.IsLeaf()) {
+      for (auto i = 0; i < node.num_faces_; i++) {
+        const auto face = face_indices_[node.first_face_ + i];
+        glm::vec3 v0, v1, v2;
+        GetFace(face, v0, v1, v2);
+        float time;
+        glm::vec3 normal;
+
+        if (box.Sweep(displacement, v0, v1, v2, time, normal) &&
+            time < hit.time_) {
+          hit.time_ = time;
+          hit.face_ = face;
+          hit.normal_ = normal;
+        }
+      }
+
+      continue;
     }
 
-    for (const auto& child : current_node.children_nodes_) {
-      Intersect(ray, child, collision_node);
+    // push the children farthest first, so the nearest is popped next
+    StackEntry children[8];
+    auto num_hit_children = 0;
+
+    for (auto i = 0; i < node.num_children_; i++) {
+      const auto child_index = node.first_child_ + i;
+      float time;
+
+      if (swept_box.Intersect(nodes_[child_index].box_, time) &&
+          time < hit.time_) {
+        children[num_hit_children++] = {child_index, time};
+      }
     }
 
-    return true;
+    PushChildrenFarthestFirst(children, num_hit_children, &StackEntry::time,
+                              stack, stack_size);
   }
 
-  return false;
+  return hit.face_ >= 0;
+}
+
+/**
+ * @brief Loads this Octree from a cache written by Save()
+ * @details The cache is memory-mapped and its arrays copied in wholesale,
+ * two sequential memcpys rather than a rebuild. The copy lets this Octree own
+ * its nodes after the file is closed and stay copyable like a built one. It
+ * is only used if it was built from an identical mesh with the same number
+ * of levels, and only if every node's children and faces are in range;
+ * otherwise this Octree is left unchanged.
+ * @param path The path of the cache file
+ * @param mesh The mesh the cache should have been built from
+ * @param num_levels The number of levels the cache should have been built with
+ * @return True if the cache was valid and loaded, false otherwise
+ */
+bool Octree::Load(const string& path, const ofMesh& mesh, int num_levels) {
+  if (num_levels > kMaxLevels) num_levels = kMaxLevels;
+
+  const MappedFile file(path);
+
+  if (!file.IsOpen() || file.get_size() < sizeof(CacheHeader)) return false;
+
+  CacheHeader header;
+  memcpy(&header, file.get_data(), sizeof(header));
+
+  if (memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+      header.version != kCacheVersion ||
+      header.num_levels != static_cast<uint32_t>(num_levels) ||
+      header.mesh_hash != Hash(mesh, num_levels)) {
+    return false;
+  }
+
+  // bounded before they are multiplied, and so they fit the int indices
+  const auto max_count =
+      static_cast<uint64_t>(std::numeric_limits<int>::max());
+
+  if (header.num_nodes == 0 || header.num_nodes > max_count ||
+      header.num_face_indices > max_count) {
+    return false;
+  }
+
+  const auto nodes_size = header.num_nodes * sizeof(TreeNode);
+  const auto face_indices_size = header.num_face_indices * sizeof(int);
+
+  if (file.get_size() != sizeof(header) + nodes_size + face_indices_size) {
+    return false;
+  }
+
+  const auto* data = file.get_data() + sizeof(header);
+
+  // the hash only proves the cache was built from this mesh, not that it
+  // survived intact, so its indices are checked before anything follows them
+  Octree octree;
+  octree.mesh_ = mesh;
+  octree.num_levels_ = num_levels;
+  octree.nodes_.resize(header.num_nodes);
+  memcpy(octree.nodes_.data(), data, nodes_size);
+  octree.face_indices_.resize(header.num_face_indices);
+  memcpy(octree.face_indices_.data(), data + nodes_size, face_indices_size);
+
+  if (!octree.IsValid()) return false;
+
+  octree.BuildChildBoxes();
+  *this = std::move(octree);
+
+  return true;
+}
+
+/**
+ * @brief Saves this Octree to a cache file, for Load() on later runs
+ * @param path The path of the cache file, which is overwritten
+ * @return True if the cache was written, false otherwise
+ */
+bool Octree::Save(const string& path) const {
+  if (nodes_.empty()) return false;
+
+  CacheHeader header;
+  memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+  header.version = kCacheVersion;
+  header.num_levels = num_levels_;
+  header.mesh_hash = Hash(mesh_, num_levels_);
+  header.num_nodes = nodes_.size();
+  header.num_face_indices = face_indices_.size();
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(nodes_.data()),
+             nodes_.size() * sizeof(TreeNode));
+  file.write(reinterpret_cast<const char*>(face_indices_.data()),
+             face_indices_.size() * sizeof(int));
+
+  return file.good();
+}
+
+/**
+ * @brief Gets the number of triangular faces in this Octree's mesh
+ * @return The number of faces
+ */
+int Octree::GetNumFaces() const {
+  if (mesh_.getNumIndices() > 0) return mesh_.getNumIndices() / 3;
+
+  return mesh_.getNumVertices() / 3;
+}
+
+/**
+ * @brief Gets the vertices of one of this Octree's mesh faces
+ * @param face The index of the face, in [0, GetNumFaces())
+ * @param v0 (SIDE EFFECT RETURN VALUE) The face's first vertex
+ * @param v1 (SIDE EFFECT RETURN VALUE) The face's second vertex
+ * @param v2 (SIDE EFFECT RETURN VALUE) The face's third vertex
+ */
+void Octree::GetFace(const int face, glm::vec3& v0, glm::vec3& v1,
+                     glm::vec3& v2) const {
+  const auto& vertices = mesh_.getVertices();
+
+  if (mesh_.getNumIndices() > 0) {
+    const auto& indices = mesh_.getIndices();
+    v0 = vertices[indices[face * 3]];
+    v1 = vertices[indices[face * 3 + 1]];
+    v2 = vertices[indices[face * 3 + 2]];
+  } else {
+    v0 = vertices[face * 3];
+    v1 = vertices[face * 3 + 1];
+    v2 = vertices[face * 3 + 2];
+  }
 }
 
 //-Private Methods----------------------------------------------
 
-void Octree::Draw(const TreeNode& node, const int num_levels,
+void Octree::BuildChildBoxes() {
+  child_boxes_.clear();
+  child_boxes_index_.assign(nodes_.size(), -1);
+
+  for (auto i = 0; i < static_cast<int>(nodes_.size()); i++) {
+    const auto& node = nodes_[i];
+
+    if (node.IsLeaf()) continue;
+
+    child_boxes_index_[i] = child_boxes_.size();
+    child_boxes_.emplace_back();
+
+    for (auto j = 0; j < node.num_children_; j++) {
+      child_boxes_.back().Set(j, nodes_[node.first_child_ + j].box_);
+    }
+  }
+}
+
+void Octree::Draw(const int node_index, const int num_levels,
                   int current_level) const {
   if (current_level >= num_levels) return;
 
   current_level++;
+  const auto& node = nodes_[node_index];
   node.box_.Draw();
 
-  for (const auto& child : node.children_nodes_) {
-    Draw(child, num_levels, current_level);
+  for (auto i = 0; i < node.num_children_; i++) {
+    Draw(node.first_child_ + i, num_levels, current_level);
+  }
+}
+
+void Octree::IntersectFaces(const Ray& ray, const TreeNode& leaf,
+                            RayHit& hit) const {
+  for (auto i = 0; i < leaf.num_faces_; i++) {
+    const auto face = face_indices_[leaf.first_face_ + i];
+    glm::vec3 v0, v1, v2;
+    GetFace(face, v0, v1, v2);
+    float distance;
+    glm::vec2 barycentric;
+
+    if (ray.Intersect(v0, v1, v2, distance, barycentric) &&
+        distance < hit.distance_) {
+      hit.distance_ = distance;
+      hit.face_ = face;
+      hit.barycentric_ = barycentric;
+    }
+  }
+}
+
+void Octree::IntersectPacket(const Ray* rays, RayHit* hits,
+                             const int num_rays) const {
+  const auto& root = nodes_[kRootNode];
+  uint32_t root_mask = 0;
+  auto root_distance = std::numeric_limits<float>::max();
+
+  for (auto i = 0; i < num_rays; i++) {
+    float distance;
+
+    if (root.box_.Intersect(rays[i], 0, hits[i].distance_, distance)) {
+      root_mask |= 1u << i;
+      root_distance = std::min(root_distance, distance);
+    }
+  }
+
+  if (root_mask == 0) return;
+
+  // each stack entry carries the subset of the packet that entered its node
+  struct StackEntry {
+    int node_index;
+    uint32_t mask;
+    float distance;  // of the nearest ray in mask
+  };
+  StackEntry stack[kStackSize];
+  auto stack_size = 0;
+  stack[stack_size++] = {kRootNode, root_mask, root_distance};
+
+  while (stack_size > 0) {
+    const auto entry = stack[--stack_size];
+    const auto& node = nodes_[entry.node_index];
+
+    if (node.IsLeaf()) {
+      for (auto mask = entry.mask; mask != 0; mask &= mask - 1) {
+        const auto i = CountTrailingZeros(mask);
+
+        // the ray may have hit something nearer since its node was pushed
+        if (node.box_.Intersect(rays[i], 0, hits[i].distance_)) {
+          IntersectFaces(rays[i], node, hits[i]);
+        }
+      }
+
+      continue;
+    }
+
+    const auto& child_boxes =
+        child_boxes_[child_boxes_index_[entry.node_index]];
+    StackEntry children[PackedBoxes::kSize];
+
+    for (auto j = 0; j < node.num_children_; j++) {
+      children[j] = {node.first_child_ + j, 0,
+                     std::numeric_limits<float>::max()};
+    }
+
+    for (auto mask = entry.mask; mask != 0; mask &= mask - 1) {
+      const auto i = CountTrailingZeros(mask);
+      float distances[PackedBoxes::kSize];
+      auto child_mask =
+          child_boxes.Intersect(rays[i], 0, hits[i].distance_, distances);
+
+      for (auto j = 0; child_mask != 0; j++, child_mask >>= 1) {
+        if ((child_mask & 1) == 0) continue;
+
+        children[j].mask |= 1u << i;
+        children[j].distance = std::min(children[j].distance, distances[j]);
+      }
+    }
+
+    // push the children farthest first, so the nearest is popped next
+    StackEntry hit_children[PackedBoxes::kSize];
+    auto num_hit_children = 0;
+
+    for (auto j = 0; j < node.num_children_; j++) {
+      if (children[j].mask != 0) hit_children[num_hit_children++] = children[j];
+    }
+
+    PushChildrenFarthestFirst(hit_children, num_hit_children,
+                              &StackEntry::distance, stack, stack_size);
   }
 }
 
-vector<int> Octree::GetMeshPointsInBox(const ofMesh& mesh,
-                                       const vector<int>& points,
-                                       const Box& box) {
-  vector<int> indices;
+bool Octree::IsValid() const {
+  const auto num_nodes = static_cast<int64_t>(nodes_.size());
+  const auto num_face_indices = static_cast<int64_t>(face_indices_.size());
+  const auto num_faces = GetNumFaces();
+
+  for (const auto face : face_indices_) {
+    if (face < 0 || face >= num_faces) return false;
+  }
+
+  // children always follow their parent, so one forward pass reaches every
+  // parent before its children, and no chain of children can loop; depth is
+  // capped so the traversal stacks cannot overflow
+  vector<int> depths(nodes_.size(), 0);
+
+  for (auto i = 0; i < static_cast<int>(nodes_.size()); i++) {
+    const auto& node = nodes_[i];
 
-  for (const auto& point : points) {
-    auto vertex = mesh.getVertex(point);
+    if (node.num_faces_ < 0 || node.first_face_ < 0 ||
+        static_cast<int64_t>(node.first_face_) + node.num_faces_ >
+            num_face_indices) {
+      return false;
+    }
+
+    if (node.IsLeaf()) continue;
+
+    if (node.num_children_ < 0 || node.num_children_ > PackedBoxes::kSize ||
+        node.first_child_ <= i ||
+        static_cast<int64_t>(node.first_child_) + node.num_children_ >
+            num_nodes ||
+        depths[i] >= kMaxLevels) {
+      return false;
+    }
 
-    if (box.Inside(vertex)) {
-      indices.push_back(point);
+    for (auto j = 0; j < node.num_children_; j++) {
+      auto& depth = depths[node.first_child_ + j];
+      depth = std::max(depth, depths[i] + 1);
     }
   }
 
-  return indices;
+  return true;
 }
 
-void Octree::Subdivide(const ofMesh& mesh, TreeNode& node, const int num_levels,
-                       int current_level) {
-  if (current_level >= num_levels) return;
+void Octree::RefitBoxes() {
+  // children always follow their parent in nodes_, so one backward pass sees
+  // every child before its parent
+  for (int i = nodes_.size() - 1; i >= 0; i--) {
+    auto& node = nodes_[i];
+    glm::vec3 min(std::numeric_limits<float>::max());
+    glm::vec3 max(std::numeric_limits<float>::lowest());
+
+    if (node.IsLeaf()) {
+      for (auto j = 0; j < node.num_faces_; j++) {
+        glm::vec3 v0, v1, v2;
+        GetFace(face_indices_[node.first_face_ + j], v0, v1, v2);
+
+        min = glm::min(min, glm::min(v0, glm::min(v1, v2)));
+        max = glm::max(max, glm::max(v0, glm::max(v1, v2)));
+      }
+    } else {
+      for (auto j = 0; j < node.num_children_; j++) {
+        const auto& child_box = nodes_[node.first_child_ + j].box_;
 
+        min = glm::min(min, child_box.get_min_corner());
+        max = glm::max(max, child_box.get_max_corner());
+      }
+    }
+
+    if (node.num_faces_ > 0) node.box_ = Box(min, max);
+  }
+}
+
+void Octree::SubdivideParallel(const vector<glm::vec3>& centroids,
+                               vector<unsigned char>& octants,
+                               const int num_levels, ThreadPool& thread_pool) {
+  auto current_level = 0;
   current_level++;
-  auto total_points = 0;
-  auto sub_boxes = SubdivideBox8(node.box_);
 
-  for (auto& box : sub_boxes) {
-    TreeNode child;
+  if (current_level >= num_levels || nodes_[kRootNode].num_faces_ <= 1) {
+    Subdivide(centroids, nodes_, face_indices_, octants, kRootNode, num_levels,
+              current_level);
+    return;
+  }
 
-    child.points_ = GetMeshPointsInBox(mesh, node.points_, box);
+  current_level++;
+  const auto root_box = nodes_[kRootNode].box_;
+  int octant_counts[8];
+  PartitionIntoOctants(centroids, root_box, face_indices_.data(),
+                       octants.data(), nodes_[kRootNode].num_faces_,
+                       octant_counts);
+
+  // build each top-level subtree into its own node array, where local node 0
+  // is the subtree's root; subtrees own disjoint ranges of face_indices_ and
+  // octants, so those are partitioned in place without locking
+  vector<vector<TreeNode>> subtree_nodes;
+  auto first_face = 0;
+
+  for (auto octant = 0; octant < 8; octant++) {
+    if (octant_counts[octant] == 0) continue;
+
+    subtree_nodes.emplace_back(1);
+    auto& subtree_root = subtree_nodes.back()[0];
+    subtree_root.box_ = GetOctantBox(root_box, octant);
+    subtree_root.first_face_ = first_face;
+    subtree_root.num_faces_ = octant_counts[octant];
+    first_face += octant_counts[octant];
+  }
+
+  vector<std::future<void>> builds;
 
-    const auto count = child.points_.size();
-    total_points += count;
+  for (auto i = 0; i < static_cast<int>(subtree_nodes.size()); i++) {
+    builds.push_back(thread_pool.Submit([&, i, current_level] {
+      Subdivide(centroids, subtree_nodes[i], face_indices_, octants, 0,
+                num_levels, current_level);
+    }));
+  }
+
+  for (auto& build : builds) {
+    build.get();
+  }
 
-    if (count > 0) {
-      child.box_ = box;
-      node.children_nodes_.push_back(child);
+  // splice the subtrees in after the root's children, rebasing their indices
+  const int num_children = subtree_nodes.size();
+  nodes_.resize(1 + num_children);
+  nodes_[kRootNode].first_child_ = 1;
+  nodes_[kRootNode].num_children_ = num_children;
 
-      if (count > 1) {
-        Subdivide(mesh, node.children_nodes_.back(), num_levels, current_level);
+  for (auto i = 0; i < num_children; i++) {
+    const int node_offset = nodes_.size() - 1;
+    const int num_subtree_nodes = subtree_nodes[i].size();
+
+    for (auto j = 0; j < num_subtree_nodes; j++) {
+      auto node = subtree_nodes[i][j];
+
+      if (!node.IsLeaf()) node.first_child_ += node_offset;
+
+      if (j == 0) {
+        nodes_[1 + i] = node;
+      } else {
+        nodes_.push_back(node);
       }
     }
   }
 }
 
-vector<Box> Octree::SubdivideBox8(const Box& box) {
+Box Octree::GetOctantBox(const Box& box, const int octant) {
   const auto min = box.get_min_corner();
   const auto max = box.get_max_corner();
-  const auto size = max - min;
-  const auto center = size / 2 + min;
-  const auto half_x_width = (max.x - min.x) / 2;
-  const auto half_y_width = (max.y - min.y) / 2;
-  const auto half_z_width = (max.z - min.z) / 2;
-  const auto height = glm::vec3(0, half_y_width, 0);
-  vector<Box> sub_boxes;
-
-  // generate "first floor"
-  Box b[8];
-  b[0] = Box(min, center);
-  b[1] = Box(b[0].get_min_corner() + glm::vec3(half_x_width, 0, 0),
-             b[0].get_max_corner() + glm::vec3(half_x_width, 0, 0));
-  b[2] = Box(b[1].get_min_corner() + glm::vec3(0, 0, half_z_width),
-             b[1].get_max_corner() + glm::vec3(0, 0, half_z_width));
-  b[3] = Box(b[2].get_min_corner() + glm::vec3(-half_x_width, 0, 0),
-             b[2].get_max_corner() + glm::vec3(-half_x_width, 0, 0));
-
-  for (auto i = 0; i < 4; i++) {
-    sub_boxes.push_back(b[i]);
-  }
-
-  // generate "second floor"
-  for (auto i = 4; i < 8; i++) {
-    b[i] = Box(b[i - 4].get_min_corner() + height,
-               b[i - 4].get_max_corner() + height);
-    sub_boxes.push_back(b[i]);
-  }
-
-  return sub_boxes;
+  const auto center = box.Center();
+
+  return Box(glm::vec3(octant & 1 ? center.x : min.x,
+                       octant & 2 ? center.y : min.y,
+                       octant & 4 ? center.z : min.z),
+             glm::vec3(octant & 1 ? max.x : center.x,
+                       octant & 2 ? max.y : center.y,
+                       octant & 4 ? max.z : center.z));
+}
+
+uint64_t Octree::Hash(const ofMesh& mesh, const int num_levels) {
+  // 64-bit FNV-1a over everything the build depends on
+  auto hash = 14695981039346656037ull;
+  const auto hash_bytes = [&hash](const void* data, const size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+
+    for (size_t i = 0; i < size; i++) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ull;
+    }
+  };
+
+  const auto& vertices = mesh.getVertices();
+  const auto& indices = mesh.getIndices();
+  const uint64_t sizes[3] = {vertices.size(), indices.size(),
+                             static_cast<uint64_t>(num_levels)};
+
+  hash_bytes(sizes, sizeof(sizes));
+  hash_bytes(vertices.data(), vertices.size() * sizeof(glm::vec3));
+  hash_bytes(indices.data(), indices.size() * sizeof(ofIndexType));
+
+  return hash;
+}
+
+void Octree::PartitionIntoOctants(const vector<glm::vec3>& centroids,
+                                  const Box& box, int* faces,
+                                  unsigned char* octants, const int num_faces,
+                                  int octant_counts[8]) {
+  const auto center = box.Center();
+
+  for (auto octant = 0; octant < 8; octant++) {
+    octant_counts[octant] = 0;
+  }
+
+  // classify each face once: its octant is a 3-bit code of which side of the
+  // center its centroid lies on, so every face goes to exactly one child
+  for (auto i = 0; i < num_faces; i++) {
+    const auto& centroid = centroids[faces[i]];
+    const auto octant = (centroid.x >= center.x ? 1 : 0) |
+                        (centroid.y >= center.y ? 2 : 0) |
+                        (centroid.z >= center.z ? 4 : 0);
+
+    octants[i] = octant;
+    octant_counts[octant]++;
+  }
+
+  // then permute in place so each octant's faces form one range, swapping
+  // every misplaced face straight into the next free slot of its octant
+  int next[8];
+  int end[8];
+  auto offset = 0;
+
+  for (auto octant = 0; octant < 8; octant++) {
+    next[octant] = offset;
+    offset += octant_counts[octant];
+    end[octant] = offset;
+  }
+
+  for (auto octant = 0; octant < 8; octant++) {
+    while (next[octant] < end[octant]) {
+      const auto i = next[octant];
+      const auto target = octants[i];
+
+      if (target == octant) {
+        next[octant]++;
+      } else {
+        std::swap(faces[i], faces[next[target]]);
+        std::swap(octants[i], octants[next[target]]);
+        next[target]++;
+      }
+    }
+  }
+}
+
+void Octree::Subdivide(const vector<glm::vec3>& centroids,
+                       vector<TreeNode>& nodes, vector<int>& face_indices,
+                       vector<unsigned char>& octants, const int node_index,
+                       const int num_levels, int current_level) {
+  if (current_level >= num_levels || nodes[node_index].num_faces_ <= 1) {
+    return;
+  }
+
+  current_level++;
+  const auto box = nodes[node_index].box_;
+  const auto first_face = nodes[node_index].first_face_;
+  int octant_counts[8];
+  PartitionIntoOctants(centroids, box, &face_indices[first_face],
+                       &octants[first_face], nodes[node_index].num_faces_,
+                       octant_counts);
+
+  // allocate all children contiguously before descending, so that each
+  // node's children form a single index range
+  const int first_child = nodes.size();
+  auto num_children = 0;
+
+  for (auto octant = 0; octant < 8; octant++) {
+    if (octant_counts[octant] > 0) num_children++;
+  }
+
+  nodes.resize(first_child + num_children);
+  nodes[node_index].first_child_ = first_child;
+  nodes[node_index].num_children_ = num_children;
+  auto child = first_child;
+  auto child_first_face = first_face;
+
+  for (auto octant = 0; octant < 8; octant++) {
+    if (octant_counts[octant] == 0) continue;
+
+    nodes[child].box_ = GetOctantBox(box, octant);
+    nodes[child].first_face_ = child_first_face;
+    nodes[child].num_faces_ = octant_counts[octant];
+    child_first_face += octant_counts[octant];
+    child++;
+  }
+
+  for (child = first_child; child < first_child + num_children; child++) {
+    Subdivide(centroids, nodes, face_indices, octants, child, num_levels,
+              current_level);
+  }
 }
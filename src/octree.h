@@ -1,6 +1,17 @@
 /**
  * @class Octree
- * @brief 3D spatial partitioning data structure
+ * @brief 3D spatial partitioning data structure over a mesh's triangles
+ * @details Nodes are stored breadth-first per parent in one contiguous array,
+ * so that the children of a node occupy a single index range. Face indices
+ * are likewise stored in one shared buffer, with each node owning a
+ * contiguous range of it. Building partitions that buffer in place by face
+ * centroid, so each child's range is a subrange of its parent's; node boxes
+ * are then refit to tightly bound their faces. Given a ThreadPool, the
+ * subtrees below the root are built concurrently and spliced into place
+ * afterwards. Since the arrays hold no pointers, a built Octree can be saved
+ * to disk and mapped straight back in on later runs. The children's boxes
+ * are also copied into PackedBoxes, so the ray query tests a node's children
+ * together.
  * @author Kevin M. Smith (CS 134 SJSU)
  * @author Patrick Silvestre
  */
@@ -9,34 +20,142 @@
 
 #include "box.h"
 #include "ofMain.h"
+#include "oriented-box.h"
+#include "packed-boxes.h"
 #include "ray.h"
+#include "thread-pool.h"
 
 class TreeNode {
  public:
+  bool IsLeaf() const { return num_children_ == 0; }
+
   Box box_;
-  vector<int> points_;
-  vector<TreeNode> children_nodes_;
+  int first_child_ = -1;  // index into Octree::nodes_
+  int num_children_ = 0;
+  int first_face_ = 0;  // index into Octree::face_indices_
+  int num_faces_ = 0;
+};
+
+class RayHit {
+ public:
+  float distance_ = 0.0f;
+  int face_ = -1;
+  glm::vec2 barycentric_ = glm::vec2(0.0f);
+  glm::vec3 point_ = glm::vec3(0.0f);
+};
+
+class SweepHit {
+ public:
+  float time_ = 1.0f;  // fraction of the displacement
+  int face_ = -1;
+  glm::vec3 normal_ = glm::vec3(0.0f);
 };
 
 class Octree {
  public:
   Octree() = default;
-  Octree(const ofMesh& mesh, int num_levels);
+  Octree(const ofMesh& mesh, int num_levels,
+         ThreadPool* thread_pool = nullptr);
 
   void Draw(int num_levels, int current_level) const;
-  bool Intersect(const Box& box, const TreeNode& current_node,
+  bool Intersect(const Box& box, vector<Box>& terrain_collision_boxes) const;
+  bool Intersect(const Box& box, vector<int>& terrain_collision_faces) const;
+  bool Intersect(const OrientedBox& box,
                  vector<Box>& terrain_collision_boxes) const;
-  bool Intersect(const Ray& ray, const TreeNode& current_node,
-                 TreeNode& collision_node) const;
+  bool Intersect(const Ray& ray, RayHit& hit,
+                 float max_distance = 10000.0f) const;
+  int Intersect(const vector<Ray>& rays, vector<RayHit>& hits,
+                float max_distance = 10000.0f) const;
+  int CountIntersections(const Box& box, int max_count = -1) const;
+  bool Sweep(const OrientedBox& box, const glm::vec3& displacement,
+             SweepHit& hit) const;
+
+  template <typename Shape, typename Visitor>
+  int VisitIntersections(const Shape& shape, Visitor visitor,
+                         int max_count = -1) const;
+
+  bool Load(const string& path, const ofMesh& mesh, int num_levels);
+  bool Save(const string& path) const;
+
+  int GetNumFaces() const;
+  void GetFace(int face, glm::vec3& v0, glm::vec3& v1, glm::vec3& v2) const;
+
+  static constexpr int kMaxLevels = 32;
+  // enough for any traversal stack: each level pushes at most 8 children, one
+  // of which is popped right away
+  static constexpr int kStackSize = 7 * kMaxLevels + 8;
+  static constexpr int kMaxPacketSize = 32;  // rays traced together
+  static constexpr int kRootNode = 0;
 
   ofMesh mesh_;
-  TreeNode root_;
+  vector<TreeNode> nodes_;
+  vector<int> face_indices_;
 
  private:
-  void Draw(const TreeNode& node, int num_levels, int current_level) const;
-  vector<int> GetMeshPointsInBox(const ofMesh& mesh, const vector<int>& points,
-                                 const Box& box);
-  void Subdivide(const ofMesh& mesh, TreeNode& node, int num_levels,
-                 int current_level);
-  vector<Box> SubdivideBox8(const Box& box);
-};
\ No newline at end of file
+  int num_levels_ = 0;
+  // the boxes of each internal node's children, packed for the ray query;
+  // derived from nodes_ rather than cached, and indexed by child_boxes_index_
+  vector<PackedBoxes> child_boxes_;
+  vector<int> child_boxes_index_;
+
+  void BuildChildBoxes();
+  void Draw(int node_index, int num_levels, int current_level) const;
+  void IntersectFaces(const Ray& ray, const TreeNode& leaf, RayHit& hit) const;
+  void IntersectPacket(const Ray* rays, RayHit* hits, int num_rays) const;
+  bool IsValid() const;
+  void RefitBoxes();
+  void SubdivideParallel(const vector<glm::vec3>& centroids,
+                         vector<unsigned char>& octants, int num_levels,
+                         ThreadPool& thread_pool);
+
+  static Box GetOctantBox(const Box& box, int octant);
+  static uint64_t Hash(const ofMesh& mesh, int num_levels);
+  static void PartitionIntoOctants(const vector<glm::vec3>& centroids,
+                                   const Box& box, int* faces,
+                                   unsigned char* octants, int num_faces,
+                                   int octant_counts[8]);
+  static void Subdivide(const vector<glm::vec3>& centroids,
+                        vector<TreeNode>& nodes, vector<int>& face_indices,
+                        vector<unsigned char>& octants, int node_index,
+                        int num_levels, int current_level);
+};
+
+/**
+ * @brief Visits the leaf nodes in this Octree intersected by a given shape
+ * @details Walks an explicit stack, so nothing is allocated; the caller
+ * decides what, if anything, to keep from each leaf.
+ * @param shape The Box or OrientedBox potentially intersecting this Octree
+ * @param visitor Called with each intersected leaf, as a const TreeNode&
+ * @param max_count (OPTIONAL) The number of leaves after which to stop
+ * early; if negative, every intersected leaf is visited
+ * @return The number of leaves visited
+ */
+template <typename Shape, typename Visitor>
+int Octree::VisitIntersections(const Shape& shape, Visitor visitor,
+                               const int max_count) const {
+  if (nodes_.empty() || max_count == 0) return 0;
+
+  int stack[kStackSize];
+  auto stack_size = 0;
+  auto count = 0;
+  stack[stack_size++] = kRootNode;
+
+  while (stack_size > 0) {
+    const auto& node = nodes_[stack[--stack_size]];
+
+    if (!shape.Overlap(node.box_)) continue;
+
+    if (node.IsLeaf()) {
+      visitor(node);
+
+      if (++count == max_count) break;
+    } else {
+      // push in reverse, so children are visited in storage order
+      for (auto i = node.num_children_ - 1; i >= 0; i--) {
+        stack[stack_size++] = node.first_child_ + i;
+      }
+    }
+  }
+
+  return count;
+}
@@ -1,5 +1,7 @@
 #include "ofApp.h"
 
+#include <random>
+
 //--------------------------------------------------------------
 void ofApp::setup() {
   ofEnableAntiAliasing();
@@ -8,35 +10,87 @@ void ofApp::setup() {
   ofSetFrameRate(60);
   ofSetVerticalSync(true);
 
-  LoadAssets();
+  StartLoadingAssets();
   SetUpCameras();
   SetUpLighting();
 
+  // a fresh seed each launch, kept across restarts; each system draws from
+  // its own stream of it
+  const auto seed = static_cast<uint64_t>(std::random_device()()) << 32 |
+                    std::random_device()();
+  lander_system_.Seed(seed, 0);
+  explosion_.random_.Seed(seed, 1);
+  thruster_.random_.Seed(seed, 2);
+
   explosion_.one_shot_ = true;
+  explosion_.particle_system_.set_thread_pool(&thread_pool_);
+  thruster_.particle_system_.set_thread_pool(&thread_pool_);
 }
 
 //--------------------------------------------------------------
-void ofApp::LoadAssets() {
-  if (background_.load("images/space.jpg")) {
-    background_.resize(ofGetWidth(), ofGetHeight());
-    background_.setImageType(OF_IMAGE_GRAYSCALE);
-  } else {
-    ofSystemAlertDialog("Background image missing. Exiting...");
-    ofExit();
-  }
+void ofApp::StartLoadingAssets() {
+  const auto width = ofGetWidth();
+  const auto height = ofGetHeight();
+
+  asset_loader_.Add("Background image missing. Exiting...", [this, width,
+                                                             height] {
+    if (!ofLoadImage(background_pixels_, "images/space.jpg")) {
+      return false;
+    }
 
-  if (!explosion_sound_player_.load("sounds/explosion.wav")) {
-    ofSystemAlertDialog("Explosion sound effect missing. Exiting...");
-    ofExit();
-  }
+    background_pixels_.resize(width, height);
+    background_pixels_.setImageType(OF_IMAGE_GRAYSCALE);
 
-  if (thrust_sound_player_.load("sounds/thrust.wav")) {
-    thrust_sound_player_.setLoop(true);
-  } else {
-    ofSystemAlertDialog("Thrust sound effect missing. Exiting...");
+    return true;
+  });
+
+  // both sounds share one worker, as the sound system initializes itself on
+  // the first load
+  asset_loader_.Add("Sound effects missing. Exiting...", [this] {
+    return explosion_sound_player_.load("sounds/explosion.wav") &&
+           thrust_sound_player_.load("sounds/thrust.wav");
+  });
+
+  asset_loader_.Add("Mars model missing. Exiting...", [this] {
+    // converts the terrain first if its mesh cache is missing or stale
+    if (!mars_.Load("geo/mars.obj") || mars_.GetNumMeshes() == 0) {
+      return false;
+    }
+
+    // reuse the Octree built on a previous run, unless the terrain changed
+    const auto& mars_mesh = mars_.GetMesh(0);
+    const auto octree_cache_path = ofToDataPath("geo/mars.octree");
+
+    if (!octree_.Load(octree_cache_path, mars_mesh, 10)) {
+      octree_ = Octree(mars_mesh, 10, &thread_pool_);
+
+      if (!octree_.Save(octree_cache_path)) {
+        cerr << "Octree cache could not be written to " << octree_cache_path
+             << endl;
+      }
+    }
+
+    return true;
+  });
+
+  asset_loader_.Start();
+}
+
+//--------------------------------------------------------------
+void ofApp::FinishLoadingAssets() {
+  const auto failures = asset_loader_.GetFailures();
+
+  if (!failures.empty()) {
+    ofSystemAlertDialog(failures.front());
     ofExit();
+    return;
   }
 
+  background_.setFromPixels(background_pixels_);
+  thrust_sound_player_.setLoop(true);
+
+  // fonts build their glyph textures as they load, so they load here on the
+  // main thread
   if (!gauge_font_.load("fonts/Source_Code_Pro/SourceCodePro-Black.ttf", 20)) {
     ofSystemAlertDialog("Font missing. Exiting...");
     ofExit();
@@ -48,32 +102,18 @@ void ofApp::LoadAssets() {
     ofExit();
   }
 
-  if (mars_.loadModel("geo/mars.obj")) {
-    mars_.setScaleNormalization(false);
-    octree_ = Octree(mars_.getMesh(0), 10);
-  } else {
-    ofSystemAlertDialog("Mars model missing. Exiting...");
+#ifdef TARGET_OPENGLES
+  const auto shader_path = "shaders-gles/shader";
+#else
+  const auto shader_path = "shaders/shader";
+#endif
+
+  if (!particle_renderer_.Load("images/particle.png", shader_path)) {
+    ofSystemAlertDialog("Particle texture or shaders missing. Exiting...");
     ofExit();
   }
 
-  // FIXME
-  //  if (ofLoadImage(particle_texture_, "images/particle.png")) {
-  //    ofDisableArbTex();
-  //  } else {
-  //    ofSystemAlertDialog("Particle texture missing. Exiting...");
-  //    ofExit();
-  //  }
-  //
-  //#ifdef TARGET_OPENGLES
-  //  if (shader_.load("shaders-gles/shader")) shaders_loaded = true;
-  //#else
-  //  if (shader_.load("shaders/shader")) shaders_loaded_ = true;
-  //#endif
-  //
-  //  if (!shaders_loaded_) {
-  //    ofSystemAlertDialog("Shaders missing. Exiting...");
-  //    ofExit();
-  //  }
+  assets_loaded_ = true;
 }
 
 //--------------------------------------------------------------
@@ -119,6 +159,11 @@ void ofApp::SetUpLighting() {
 
 //--------------------------------------------------------------
 void ofApp::update() {
+  if (!assets_loaded_) {
+    if (asset_loader_.IsDone()) FinishLoadingAssets();
+    return;
+  }
+
   UpdateCameras();
   UpdateLighting();
 
@@ -126,18 +171,28 @@ void ofApp::update() {
 
   background_.resize(ofGetWidth(), ofGetHeight());
 
-  explosion_.Update();
+  // the simulation advances in fixed steps, independent of the frame rate
+  simulation_clock_.Advance(ofGetLastFrameTime());
+
+  while (simulation_clock_.Step()) {
+    StepSimulation(simulation_clock_.GetFrameTime());
+  }
 
   if (game_over_) {
     // display gui so user knows how to reset in case they disabled the gui
     gui_displayed_ = true;
   }
+}
+
+//--------------------------------------------------------------
+void ofApp::StepSimulation(const FrameTime& frame_time) {
+  explosion_.Update(frame_time);
 
   if (!game_over_ && !successful_landing_) {
-    lander_system_.Update(octree_);
+    lander_system_.Update(octree_, frame_time);
 
     thruster_.position_ = lander_system_.get_position();
-    thruster_.Update();
+    thruster_.Update(frame_time);
 
     CheckWinCondition();
   }
@@ -165,26 +220,30 @@ void ofApp::UpdateLighting() {
 
 //--------------------------------------------------------------
 void ofApp::CheckWinCondition() {
-  if (lander_system_.is_colliding()) {
-    if (glm::length(lander_system_.get_velocity()) < velocity_threshold_) {
-      if (glm::length(landing_area_ - lander_system_.get_position()) < 5.0f) {
-        successful_landing_ = true;
-        game_over_ = true;
-      }
-    } else {
+  switch (lander_system_.CheckTouchdown(landing_area_, velocity_threshold_)) {
+    case Touchdown::kLanded:
+      successful_landing_ = true;
+      game_over_ = true;
+      break;
+    case Touchdown::kCrashed:
       explosion_.position_ = lander_system_.get_position();
-      explosion_.Start();
+      explosion_.Start(simulation_clock_.GetTime());
       explosion_sound_player_.play();
 
       exploded_ = true;
       game_over_ = true;
-    }
+      break;
+    default:
+      break;
   }
 }
 
 //--------------------------------------------------------------
 void ofApp::draw() {
-  // SetUpVertexBuffer();
+  if (!assets_loaded_) {
+    DrawLoadingScreen();
+    return;
+  }
 
   ofDisableLighting();
   ofDisableDepthTest();
@@ -195,16 +254,19 @@ void ofApp::draw() {
 
   current_cam_->begin();
 
-  mars_.drawFaces();
+  mars_.DrawFaces();
+
+  const auto point_scale = ParticleRenderer::GetPointScale(
+      current_cam_->getFov(), ofGetViewportHeight());
 
   if (!game_over_) {
     lander_system_.Draw();
-    thruster_.Draw();
+    particle_renderer_.Draw(thruster_.particle_system_, point_scale);
   } else {
     if (successful_landing_) {
       lander_system_.Draw();
     } else {
-      explosion_.Draw();
+      particle_renderer_.Draw(explosion_.particle_system_, point_scale);
     }
   }
 
@@ -222,14 +284,10 @@ void ofApp::draw() {
   }
   ofDrawSphere(landing_area_, 7.0f);
 
-  // FIXME
-  // ofSetColor(ofColor::white);
-  // shader_.begin();
-  // particle_texture_.bind();
-  // vertex_buffer_.draw(GL_POINTS, 0,
-  //                    thruster_.particle_system_.particles_.size());
-  // particle_texture_.unbind();
-  // shader_.end();
+  if (terrain_selected_) {
+    ofSetColor(ofColor::white);
+    ofDrawSphere(terrain_hit_.point_, 0.25f);
+  }
 
   current_cam_->end();
 
@@ -250,26 +308,6 @@ void ofApp::draw() {
   ofEnableLighting();
 }
 
-////--------------------------------------------------------------
-// void ofApp::SetUpVertexBuffer() {
-//  // FIXME
-//  if (thruster_.particle_system_.particles_.empty()) return;
-//
-//  vector<glm::vec3> points;
-//  vector<glm::vec3> sizes;
-//
-//  for (auto& particle : thruster_.particle_system_.particles_) {
-//    points.push_back(particle->position_);
-//    sizes.push_back(glm::vec3(1.0f));
-//  }
-//
-//  const int total = points.size();
-//
-//  vertex_buffer_.clear();
-//  vertex_buffer_.setVertexData(&points[0], total, GL_STATIC_DRAW);
-//  vertex_buffer_.setNormalData(&sizes[0], total, GL_STATIC_DRAW);
-//}
-
 //--------------------------------------------------------------
 void ofApp::DrawAltimeterGauge() const {
   const auto altimeter_message =
@@ -282,6 +320,27 @@ void ofApp::DrawAltimeterGauge() const {
                          bounding_box.height + 50.0f);
 }
 
+//--------------------------------------------------------------
+void ofApp::DrawLoadingScreen() const {
+  const auto bar_width = ofGetWidth() / 3.0f;
+  const auto bar_height = 20.0f;
+  const auto x = (ofGetWidth() - bar_width) / 2.0f;
+  const auto y = ofGetHeight() / 2.0f;
+
+  ofDisableLighting();
+  ofDisableDepthTest();
+
+  ofSetColor(255, 255, 255, 180);
+  ofDrawBitmapString("loading...", x, y - 10.0f);
+  ofNoFill();
+  ofDrawRectangle(x, y, bar_width, bar_height);
+  ofFill();
+  ofDrawRectangle(x, y, bar_width * asset_loader_.GetProgress(), bar_height);
+
+  ofEnableDepthTest();
+  ofEnableLighting();
+}
+
 //--------------------------------------------------------------
 void ofApp::DrawAxis(const glm::vec3& location) const {
   // Draw an XYZ axis in RGB at world (0,0,0) for reference.
@@ -362,6 +421,8 @@ void ofApp::DrawVelocityGauge() const {
 
 //--------------------------------------------------------------
 void ofApp::keyPressed(const int key) {
+  if (!assets_loaded_) return;
+
   switch (key) {
     case 'H':
     case 'h':
@@ -469,7 +530,7 @@ void ofApp::Reset() {
 void ofApp::StartThrusterEffects() {
   if (!thruster_light_.getIsEnabled()) thruster_light_.enable();
   if (!thrust_sound_player_.isPlaying()) thrust_sound_player_.play();
-  thruster_.Start();
+  thruster_.Start(simulation_clock_.GetTime());
   fuel_ -= 1.0f / 30.0f;
 }
 
@@ -503,6 +564,8 @@ void ofApp::mouseMoved(int x, int y) {}
 
 //--------------------------------------------------------------
 void ofApp::mouseDragged(int x, int y, int button) {
+  if (!assets_loaded_) return;
+
   if (free_cam_.getMouseInputEnabled()) return;
 
   if (dragging_) {
@@ -547,14 +610,16 @@ glm::vec3 ofApp::GetMousePointOnPlane(const glm::vec3& plane_origin,
 
 //--------------------------------------------------------------
 void ofApp::mousePressed(int x, int y, int button) {
+  if (!assets_loaded_) return;
+
   if (free_cam_.getMouseInputEnabled()) return;
 
   const auto origin = free_cam_.getPosition();
   const auto mouse_world_space =
       free_cam_.screenToWorld(glm::vec3(mouseX, mouseY, 0));
   const auto mouse_direction = glm::normalize(mouse_world_space - origin);
-  const auto hit = lander_system_.get_bounds().Intersect(
-      Ray(origin, mouse_direction), 0, 10000);
+  const auto mouse_ray = Ray(origin, mouse_direction);
+  const auto hit = lander_system_.get_bounds().Intersect(mouse_ray, 0, 10000);
 
   if (hit) {
     lander_system_.select();
@@ -564,7 +629,7 @@ void ofApp::mousePressed(int x, int y, int button) {
                                            free_cam_.getZAxis());
   } else {
     lander_system_.unselect();
-    terrain_selected_ = true;
+    terrain_selected_ = octree_.Intersect(mouse_ray, terrain_hit_);
     dragging_ = false;
   }
 }
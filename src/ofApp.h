@@ -3,34 +3,39 @@
  * @brief Application main entry point
  * @author Kevin M. Smith (CS 134 SJSU)
  * @author Patrick Silvestre
- *
- * TODO fix shaders
  */
 
 #pragma once
 
+#include "asset-loader.h"
+#include "cached-model.h"
+#include "constants.h"
 #include "glm/gtx/intersect.hpp"
 #include "lander-system.h"
 #include "octree.h"
 #include "ofMain.h"
-#include "ofxAssimpModelLoader.h"
 //#include "ofxGui.h"
 #include "particle-emitter.h"
+#include "particle-renderer.h"
+#include "simulation-clock.h"
+#include "thread-pool.h"
 
 class ofApp : public ofBaseApp {
  public:
   void setup() override;
-  void LoadAssets();
+  void StartLoadingAssets();
+  void FinishLoadingAssets();
   void SetUpCameras();
   void SetUpLighting();
 
   void update() override;
   void UpdateCameras();
   void UpdateLighting();
+  void StepSimulation(const FrameTime& frame_time);
   void CheckWinCondition();
 
   void draw() override;
-  // void SetUpVertexBuffer();
+  void DrawLoadingScreen() const;
   void DrawAltimeterGauge() const;
   void DrawAxis(const glm::vec3& location) const;
   void DrawControlHints() const;
@@ -52,16 +57,16 @@ class ofApp : public ofBaseApp {
   void mousePressed(int x, int y, int button) override;
   void mouseReleased(int x, int y, int button) override;
 
+  bool assets_loaded_ = false;
   bool dragging_ = false;
   bool exploded_ = false;
   bool game_over_ = false;
   bool gui_displayed_ = true;
-  bool shaders_loaded_ = false;
   bool successful_landing_ = false;
-  bool terrain_selected_ = true;
+  bool terrain_selected_ = false;
 
   float fuel_ = 15.0f;
-  float velocity_threshold_ = 4.0f;
+  float velocity_threshold_ = constants::kVelocityThreshold;
 
   ofCamera* current_cam_ = &follow_cam_;
   ofCamera follow_cam_;
@@ -70,6 +75,7 @@ class ofApp : public ofBaseApp {
   ofEasyCam free_cam_;
 
   ofImage background_;
+  ofPixels background_pixels_;
 
   ofLight landing_area_light_;
   ofLight terrain_light_;
@@ -81,17 +87,23 @@ class ofApp : public ofBaseApp {
   ofTrueTypeFont gauge_font_;
   ofTrueTypeFont control_hint_font_;
 
-  ofxAssimpModelLoader mars_;
+  CachedModel mars_;
 
-  // ofTexture particle_texture_;
-  // ofShader shader_;
-  // ofVbo vertex_buffer_;
+  ParticleRenderer particle_renderer_;
 
-  glm::vec3 landing_area_ = glm::vec3(-10.0f, -10.0f, 40.0f);
+  glm::vec3 landing_area_ = constants::kLandingArea;
   glm::vec3 mouse_last_pos_ = glm::vec3(0.0f);
+  RayHit terrain_hit_;
 
+  SimulationClock simulation_clock_;
+
+  ThreadPool thread_pool_;
   Octree octree_;
   LanderSystem lander_system_;
   ParticleEmitter explosion_;
   ThrustParticleEmitter thruster_;
+
+  // declared last so it is destroyed first, waiting on any loads still
+  // writing to the members above
+  AssetLoader asset_loader_;
 };
@@ -0,0 +1,256 @@
+#include "oriented-box.h"
+
+/**
+ * @brief Creates an OrientedBox covering the same space as a Box
+ * @param box The Box to cover
+ */
+OrientedBox::OrientedBox(const Box& box)
+    : center_{box.Center()},
+      half_size_{(box.get_max_corner() - box.get_min_corner()) / 2.0f},
+      bounds_{box} {}
+
+/**
+ * @brief Creates an OrientedBox by transforming a Box
+ * @param box The Box, in its own model space
+ * @param transformation The model's rotation and translation, and possibly
+ * scale; shear is not supported
+ */
+OrientedBox::OrientedBox(const Box& box, const glm::mat4& transformation)
+    : center_{transformation * glm::vec4(box.Center(), 1.0f)} {
+  const auto half_size = (box.get_max_corner() - box.get_min_corner()) / 2.0f;
+  auto extent = glm::vec3(0.0f);
+
+  for (auto i = 0; i < 3; i++) {
+    const auto axis = glm::vec3(transformation[i]);
+    const auto scale = glm::length(axis);
+
+    axes_[i] = axis / scale;
+    half_size_[i] = half_size[i] * scale;
+    extent += glm::abs(axes_[i]) * half_size_[i];
+  }
+
+  bounds_ = Box(center_ - extent, center_ + extent);
+}
+
+/**
+ * @brief Draws this OrientedBox's wireframe
+ */
+void OrientedBox::Draw() const {
+  const auto transformation =
+      glm::mat4(glm::vec4(axes_[0], 0.0f), glm::vec4(axes_[1], 0.0f),
+                glm::vec4(axes_[2], 0.0f), glm::vec4(center_, 1.0f));
+
+  ofPushMatrix();
+  ofMultMatrix(transformation);
+  ofNoFill();
+  ofDrawBox(glm::vec3(0.0f), half_size_.x * 2, half_size_.y * 2,
+            half_size_.z * 2);
+  ofPopMatrix();
+}
+
+/**
+ * @brief Determines if this OrientedBox overlaps with an axis-aligned Box
+ * @details Checks the enclosing axis-aligned Box first, which rejects most
+ * far-off Boxes cheaply, then the 15 separating axes of two boxes. Like
+ * Box::Overlap(const Box&), merely touching does not count as overlapping.
+ * @param box The Box to check
+ * @return True if this OrientedBox overlaps the Box, false otherwise
+ */
+bool OrientedBox::Overlap(const Box& box) const {
+  if (!bounds_.Overlap(box)) return false;
+
+  const auto box_half_size =
+      (box.get_max_corner() - box.get_min_corner()) / 2.0f;
+  const auto offset = center_ - box.Center();
+
+  // rotation[i][j] is world axis i dotted with this box's axis j; the epsilon
+  // keeps near-parallel edges from producing a spurious cross-product axis
+  float rotation[3][3];
+  float abs_rotation[3][3];
+
+  for (auto i = 0; i < 3; i++) {
+    for (auto j = 0; j < 3; j++) {
+      rotation[i][j] = axes_[j][i];
+      abs_rotation[i][j] = abs(rotation[i][j]) + 1e-6f;
+    }
+  }
+
+  // the Box's face normals
+  for (auto i = 0; i < 3; i++) {
+    const auto radius = half_size_.x * abs_rotation[i][0] +
+                        half_size_.y * abs_rotation[i][1] +
+                        half_size_.z * abs_rotation[i][2];
+
+    if (abs(offset[i]) >= box_half_size[i] + radius) return false;
+  }
+
+  // this OrientedBox's face normals
+  for (auto j = 0; j < 3; j++) {
+    const auto radius = box_half_size.x * abs_rotation[0][j] +
+                        box_half_size.y * abs_rotation[1][j] +
+                        box_half_size.z * abs_rotation[2][j];
+
+    if (abs(glm::dot(offset, axes_[j])) >= radius + half_size_[j]) {
+      return false;
+    }
+  }
+
+  // cross products of the Box's edges with this OrientedBox's edges
+  for (auto i = 0; i < 3; i++) {
+    const auto i1 = (i + 1) % 3;
+    const auto i2 = (i + 2) % 3;
+
+    for (auto j = 0; j < 3; j++) {
+      const auto j1 = (j + 1) % 3;
+      const auto j2 = (j + 2) % 3;
+      const auto box_radius = box_half_size[i1] * abs_rotation[i2][j] +
+                              box_half_size[i2] * abs_rotation[i1][j];
+      const auto radius = half_size_[j1] * abs_rotation[i][j2] +
+                          half_size_[j2] * abs_rotation[i][j1];
+      const auto distance =
+          abs(offset[i2] * rotation[i1][j] - offset[i1] * rotation[i2][j]);
+
+      if (distance >= box_radius + radius) return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Determines when this OrientedBox, moving in a straight line without
+ * turning, first touches a triangle
+ * @details See Box::Sweep(), which this runs in this OrientedBox's frame.
+ * @param displacement How far this OrientedBox moves, in total
+ * @param v0 The triangle's first vertex
+ * @param v1 The triangle's second vertex
+ * @param v2 The triangle's third vertex
+ * @param time (SIDE EFFECT RETURN VALUE) The time of impact, as a fraction of
+ * displacement in [0, 1]
+ * @param normal (SIDE EFFECT RETURN VALUE) The unit separating axis the
+ * OrientedBox crosses last, facing against the motion
+ * @return True if this OrientedBox starts to overlap the triangle during the
+ * motion, false otherwise
+ */
+bool OrientedBox::Sweep(const glm::vec3& displacement, const glm::vec3& v0,
+                        const glm::vec3& v1, const glm::vec3& v2, float& time,
+                        glm::vec3& normal) const {
+  const auto local_box = Box(-half_size_, half_size_);
+  glm::vec3 local_normal;
+
+  if (!local_box.Sweep(ToLocal(displacement), ToLocal(v0 - center_),
+                       ToLocal(v1 - center_), ToLocal(v2 - center_), time,
+                       local_normal)) {
+    return false;
+  }
+
+  normal = axes_[0] * local_normal.x + axes_[1] * local_normal.y +
+           axes_[2] * local_normal.z;
+
+  return true;
+}
+
+/**
+ * @brief Moves this OrientedBox without turning it
+ * @param offset How far to move
+ */
+void OrientedBox::Translate(const glm::vec3& offset) {
+  center_ += offset;
+  bounds_ = Box(bounds_.get_min_corner() + offset,
+                bounds_.get_max_corner() + offset);
+}
+
+/**
+ * @brief Sets up an OrientedBox's motion for testing against Boxes
+ * @param box The OrientedBox at the start of the motion
+ * @param displacement How far the OrientedBox moves, in total
+ */
+SweptOrientedBox::SweptOrientedBox(const OrientedBox& box,
+                                   const glm::vec3& displacement) {
+  const auto& bounds = box.get_bounds();
+  bounds_ = Box(glm::min(bounds.get_min_corner(),
+                         bounds.get_min_corner() + displacement),
+                glm::max(bounds.get_max_corner(),
+                         bounds.get_max_corner() + displacement));
+
+  const auto add_axis = [&](const glm::vec3& axis) {
+    // edges parallel to a world axis give a degenerate axis, which separates
+    // nothing
+    if (glm::dot(axis, axis) < 1e-12f) return;
+
+    const auto half_size = box.get_half_size();
+    axes_[num_axes_] = axis;
+    abs_axes_[num_axes_] = glm::abs(axis);
+    centers_[num_axes_] = glm::dot(box.get_center(), axis);
+    radii_[num_axes_] = half_size.x * abs(glm::dot(box.get_axis(0), axis)) +
+                        half_size.y * abs(glm::dot(box.get_axis(1), axis)) +
+                        half_size.z * abs(glm::dot(box.get_axis(2), axis));
+    speeds_[num_axes_] = glm::dot(displacement, axis);
+    num_axes_++;
+  };
+
+  for (auto i = 0; i < 3; i++) {
+    auto world_axis = glm::vec3(0.0f);
+    world_axis[i] = 1.0f;
+
+    add_axis(world_axis);
+    add_axis(box.get_axis(i));
+
+    for (auto j = 0; j < 3; j++) {
+      add_axis(glm::cross(world_axis, box.get_axis(j)));
+    }
+  }
+}
+
+/**
+ * @brief Determines when this SweptOrientedBox first overlaps a Box
+ * @details Checks the axis-aligned Box around the whole motion first, which
+ * rejects most far-off Boxes cheaply. Unlike Box::Sweep(), overlap at the
+ * start counts, as an impact at time 0.
+ * @param box The Box to check
+ * @param time (SIDE EFFECT RETURN VALUE) When the two first overlap, as a
+ * fraction of the displacement in [0, 1]
+ * @return True if the moving box overlaps the Box at any point during the
+ * motion, false otherwise
+ */
+bool SweptOrientedBox::Intersect(const Box& box, float& time) const {
+  if (!bounds_.Overlap(box)) return false;
+
+  const auto box_center = box.Center();
+  const auto box_half_size =
+      (box.get_max_corner() - box.get_min_corner()) / 2.0f;
+  auto enter_time = 0.0f;
+  auto exit_time = 1.0f;
+
+  for (auto i = 0; i < num_axes_; i++) {
+    const auto radius = radii_[i] + glm::dot(box_half_size, abs_axes_[i]);
+    const auto distance = centers_[i] - glm::dot(box_center, axes_[i]);
+    const auto speed = speeds_[i];
+
+    if (speed == 0.0f) {
+      if (abs(distance) >= radius) return false;
+      continue;
+    }
+
+    auto axis_enter_time = (-radius - distance) / speed;
+    auto axis_exit_time = (radius - distance) / speed;
+
+    if (speed < 0.0f) std::swap(axis_enter_time, axis_exit_time);
+
+    enter_time = std::max(enter_time, axis_enter_time);
+    exit_time = std::min(exit_time, axis_exit_time);
+
+    if (enter_time >= exit_time) return false;
+  }
+
+  time = enter_time;
+
+  return true;
+}
+
+//-Private Methods----------------------------------------------
+
+glm::vec3 OrientedBox::ToLocal(const glm::vec3& vector) const {
+  return glm::vec3(glm::dot(vector, axes_[0]), glm::dot(vector, axes_[1]),
+                   glm::dot(vector, axes_[2]));
+}
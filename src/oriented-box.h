@@ -0,0 +1,73 @@
+/**
+ * @class OrientedBox
+ * @brief Bounding box that turns with the object it bounds, for tighter
+ * overlap tests than an axis-aligned Box
+ * @details Overlap tests first check the axis-aligned Box around this one,
+ * and only then run the full separating axis test, as described in Stefan
+ * Gottschalk, Ming C. Lin, and Dinesh Manocha "OBBTree: A Hierarchical
+ * Structure for Rapid Interference Detection" SIGGRAPH 1996. Triangle tests
+ * move the triangle into this box's frame and reuse Box.
+ * @author Patrick Silvestre
+ */
+
+#pragma once
+
+#include "box.h"
+#include "ofMain.h"
+
+class OrientedBox {
+ public:
+  OrientedBox() = default;
+  explicit OrientedBox(const Box& box);
+  OrientedBox(const Box& box, const glm::mat4& transformation);
+
+  glm::vec3 get_axis(int axis) const { return axes_[axis]; }
+  glm::vec3 get_center() const { return center_; }
+  glm::vec3 get_half_size() const { return half_size_; }
+  const Box& get_bounds() const { return bounds_; }
+
+  void Draw() const;
+  bool Overlap(const Box& box) const;
+  bool Sweep(const glm::vec3& displacement, const glm::vec3& v0,
+             const glm::vec3& v1, const glm::vec3& v2, float& time,
+             glm::vec3& normal) const;
+  void Translate(const glm::vec3& offset);
+
+ private:
+  glm::vec3 ToLocal(const glm::vec3& vector) const;
+
+  glm::vec3 center_ = glm::vec3(0.0f);
+  glm::vec3 axes_[3] = {glm::vec3(1.0f, 0.0f, 0.0f),
+                        glm::vec3(0.0f, 1.0f, 0.0f),
+                        glm::vec3(0.0f, 0.0f, 1.0f)};  // unit length
+  glm::vec3 half_size_ = glm::vec3(0.0f);
+  Box bounds_;  // the axis-aligned Box enclosing this one
+};
+
+/**
+ * @class SweptOrientedBox
+ * @brief An OrientedBox moving in a straight line without turning, set up to
+ * be tested against many axis-aligned Boxes, as in a broad phase
+ * @details Uses the 15 separating axes of OrientedBox::Overlap(const Box&),
+ * extended to motion as in Box::Sweep(). Everything about the axes that does
+ * not depend on the Box, such as the moving box's projected radius and speed,
+ * is worked out once up front, leaving a few dot products per axis per Box.
+ * @author Patrick Silvestre
+ */
+class SweptOrientedBox {
+ public:
+  SweptOrientedBox(const OrientedBox& box, const glm::vec3& displacement);
+
+  bool Intersect(const Box& box, float& time) const;
+
+ private:
+  static constexpr int kMaxAxes = 15;
+
+  int num_axes_ = 0;
+  glm::vec3 axes_[kMaxAxes];
+  glm::vec3 abs_axes_[kMaxAxes];
+  float centers_[kMaxAxes];  // the moving box's centre, projected at time 0
+  float radii_[kMaxAxes];    // the moving box's projected half size
+  float speeds_[kMaxAxes];   // the displacement, projected
+  Box bounds_;  // the axis-aligned Box around the whole motion
+};
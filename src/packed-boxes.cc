@@ -0,0 +1,133 @@
+#include "packed-boxes.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PACKED_BOXES_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Creates PackedBoxes whose slots are all empty
+ */
+PackedBoxes::PackedBoxes() {
+  for (auto axis = 0; axis < 3; axis++) {
+    for (auto i = 0; i < kSize; i++) {
+      corners_[0][axis][i] = std::numeric_limits<float>::infinity();
+      corners_[1][axis][i] = -std::numeric_limits<float>::infinity();
+    }
+  }
+}
+
+/**
+ * @brief Stores a Box in one of these PackedBoxes' slots
+ * @param index The slot, in [0, kSize)
+ * @param box The Box to store
+ */
+void PackedBoxes::Set(const int index, const Box& box) {
+  const auto min_corner = box.get_min_corner();
+  const auto max_corner = box.get_max_corner();
+
+  for (auto axis = 0; axis < 3; axis++) {
+    corners_[0][axis][index] = min_corner[axis];
+    corners_[1][axis][index] = max_corner[axis];
+  }
+}
+
+/**
+ * @brief Determines which of these PackedBoxes a ray intersects, and where
+ * it enters each
+ * @param ray The ray to test
+ * @param z_buffer_min The minimum z-buffer distance for culling
+ * @param z_buffer_max The maximum z-buffer distance for culling
+ * @param distances (SIDE EFFECT RETURN VALUE) For each intersected slot, the
+ * distance along the ray at which it enters that box, no less than
+ * z_buffer_min; other slots are left unspecified
+ * @return A mask with bit i set if the ray intersects the box in slot i
+ */
+int PackedBoxes::Intersect(const Ray& ray, const float z_buffer_min,
+                           const float z_buffer_max,
+                           float distances[kSize]) const {
+  const auto* x_near = corners_[ray.sign_[0]][0];
+  const auto* x_far = corners_[1 - ray.sign_[0]][0];
+  const auto* y_near = corners_[ray.sign_[1]][1];
+  const auto* y_far = corners_[1 - ray.sign_[1]][1];
+  const auto* z_near = corners_[ray.sign_[2]][2];
+  const auto* z_far = corners_[1 - ray.sign_[2]][2];
+  auto mask = 0;
+
+#ifdef PACKED_BOXES_SSE2
+  const auto origin_x = _mm_set1_ps(ray.origin_.x);
+  const auto origin_y = _mm_set1_ps(ray.origin_.y);
+  const auto origin_z = _mm_set1_ps(ray.origin_.z);
+  const auto inverse_x = _mm_set1_ps(ray.inverse_direction_.x);
+  const auto inverse_y = _mm_set1_ps(ray.inverse_direction_.y);
+  const auto inverse_z = _mm_set1_ps(ray.inverse_direction_.z);
+  const auto z_buffer_min_4 = _mm_set1_ps(z_buffer_min);
+  const auto z_buffer_max_4 = _mm_set1_ps(z_buffer_max);
+
+  // unaligned loads, since vector<PackedBoxes> need not honour alignas(16)
+  // under C++14, and they cost the same as aligned ones on aligned data
+  for (auto i = 0; i < kSize; i += 4) {
+    auto x_min =
+        _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(x_near + i), origin_x), inverse_x);
+    auto x_max =
+        _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(x_far + i), origin_x), inverse_x);
+    const auto y_min =
+        _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(y_near + i), origin_y), inverse_y);
+    const auto y_max =
+        _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(y_far + i), origin_y), inverse_y);
+
+    // written as "not greater than" so NaN slabs pass, as in Box::Intersect()
+    auto hit = _mm_and_ps(_mm_cmpngt_ps(x_min, y_max),
+                          _mm_cmpngt_ps(y_min, x_max));
+
+    // _mm_max_ps(a, b) is a > b ? a : b, which keeps x_min when either is NaN
+    x_min = _mm_max_ps(y_min, x_min);
+    x_max = _mm_min_ps(y_max, x_max);
+
+    const auto z_min =
+        _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(z_near + i), origin_z), inverse_z);
+    const auto z_max =
+        _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(z_far + i), origin_z), inverse_z);
+
+    hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpngt_ps(x_min, z_max),
+                                     _mm_cmpngt_ps(z_min, x_max)));
+
+    x_min = _mm_max_ps(z_min, x_min);
+    x_max = _mm_min_ps(z_max, x_max);
+
+    hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmplt_ps(x_min, z_buffer_max_4),
+                                     _mm_cmpgt_ps(x_max, z_buffer_min_4)));
+
+    _mm_storeu_ps(distances + i, _mm_max_ps(x_min, z_buffer_min_4));
+    mask |= _mm_movemask_ps(hit) << i;
+  }
+#else
+  for (auto i = 0; i < kSize; i++) {
+    auto x_min = (x_near[i] - ray.origin_.x) * ray.inverse_direction_.x;
+    auto x_max = (x_far[i] - ray.origin_.x) * ray.inverse_direction_.x;
+    const auto y_min = (y_near[i] - ray.origin_.y) * ray.inverse_direction_.y;
+    const auto y_max = (y_far[i] - ray.origin_.y) * ray.inverse_direction_.y;
+
+    if (x_min > y_max || y_min > x_max) continue;
+
+    if (y_min > x_min) x_min = y_min;
+    if (y_max < x_max) x_max = y_max;
+
+    const auto z_min = (z_near[i] - ray.origin_.z) * ray.inverse_direction_.z;
+    const auto z_max = (z_far[i] - ray.origin_.z) * ray.inverse_direction_.z;
+
+    if (x_min > z_max || z_min > x_max) continue;
+
+    if (z_min > x_min) x_min = z_min;
+    if (z_max < x_max) x_max = z_max;
+
+    if (x_min < z_buffer_max && x_max > z_buffer_min) {
+      distances[i] = x_min > z_buffer_min ? x_min : z_buffer_min;
+      mask |= 1 << i;
+    }
+  }
+#endif
+
+  return mask;
+}
@@ -0,0 +1,30 @@
+/**
+ * @class PackedBoxes
+ * @brief Up to eight axis-aligned bounding boxes, stored one coordinate per
+ * array, for testing a ray against all of them at once
+ * @details Uses the same slab test as Box::Intersect(), four boxes per SSE
+ * register where available, so both give identical answers. Unused slots are
+ * empty boxes that no ray hits.
+ * @author Patrick Silvestre
+ */
+
+#pragma once
+
+#include "box.h"
+#include "ray.h"
+
+class PackedBoxes {
+ public:
+  static constexpr int kSize = 8;
+
+  PackedBoxes();
+
+  void Set(int index, const Box& box);
+  int Intersect(const Ray& ray, float z_buffer_min, float z_buffer_max,
+                float distances[kSize]) const;
+
+ private:
+  // corners_[0] holds the min corners and corners_[1] the max corners,
+  // indexed like Box::corners_ so ray.sign_ picks the near and far planes
+  float corners_[2][3][kSize];
+};
@@ -2,74 +2,56 @@
 
 void ParticleEmitter::Draw() const { particle_system_.Draw(); }
 
-void ParticleEmitter::Update() {
-  const float current_time = ofGetElapsedTimeMillis();
+void ParticleEmitter::Update(const FrameTime& frame_time) {
+  const auto time = frame_time.time_;
 
   if (one_shot_ && started_) {
     if (!fired_) {
-      for (auto i = 0; i < group_size_; i++) {
-        Spawn(current_time);
-      }
+      Spawn(group_size_);
 
-      last_spawn_time_ = current_time;
+      last_spawn_time_ = time;
     }
 
     fired_ = true;
     started_ = false;
   }
 
-  if (current_time - last_spawn_time_ > 1000.0f / rate_ && started_) {
-    for (auto i = 0; i < group_size_; i++) {
-      Spawn(current_time);
-    }
+  if (time - last_spawn_time_ > 1.0f / rate_ && started_) {
+    Spawn(group_size_);
 
-    last_spawn_time_ = current_time;
+    last_spawn_time_ = time;
   }
 
-  particle_system_.Update();
+  particle_system_.Update(frame_time);
 }
 
-void ParticleEmitter::Start() {
+void ParticleEmitter::Start(float time) {
   started_ = true;
-  last_spawn_time_ = ofGetElapsedTimeMillis();
+  last_spawn_time_ = time;
 }
 
 void ParticleEmitter::Stop() { started_ = false; }
 
-void ParticleEmitter::Spawn(float spawn_time) {
-  auto* particle = new Particle();
-
-  particle->lifespan_ += ofRandom(-0.5f, 0.5f);
+void ParticleEmitter::Spawn(int num_particles) {
+  auto batch = particle_system_.AddParticles(num_particles);
 
-  particle->radius_ += ofRandom(-0.05f, 0.05f);
+  random_.FillUniform(batch.lifespans_, batch.num_particles_,
+                      particle_lifespan_ - 0.5f, particle_lifespan_ + 0.5f);
+  random_.FillUniform(batch.radii_, batch.num_particles_,
+                      particle_radius_ - 0.05f, particle_radius_ + 0.05f);
 
-  particle->position_ = position_;
-
-  // randomize velocity based on a sphere's coordinates
+  // randomize velocity within a sphere; speeds follow the square root of a
+  // uniform draw, which leaves more slow sparks near the centre than a
+  // uniform sphere would
   const auto sphere_radius = 25.0f;
-  const auto random_radius = sphere_radius * sqrt(ofRandom(1.0f));
-
-  auto x = ofRandom(-1.0f, 1.0f);
-  auto y = ofRandom(-1.0f, 1.0f);
-  auto z = ofRandom(-1.0f, 1.0f);
 
-  // normalize
-  x *= 1 / sqrt(x * x + y * y + z * z);
-  y *= 1 / sqrt(x * x + y * y + z * z);
-  z *= 1 / sqrt(x * x + y * y + z * z);
-
-  // grow points based on sphere's radius
-  x *= random_radius;
-  y *= random_radius;
-  z *= random_radius;
-
-  initial_velocity_.x = x;
-  initial_velocity_.y = y;
-  initial_velocity_.z = z;
-
-  particle->velocity_ = initial_velocity_;
+  for (auto i = 0; i < batch.num_particles_; i++) {
+    const auto random_radius = sphere_radius * sqrt(random_.NextFloat());
+    batch.velocities_[i] = random_.Direction() * random_radius;
+  }
 
-  particle_system_.AddParticle(particle);
+  std::fill(batch.positions_, batch.positions_ + batch.num_particles_,
+            position_);
 }
 
 ThrustParticleEmitter::ThrustParticleEmitter() {
@@ -78,36 +60,22 @@ ThrustParticleEmitter::ThrustParticleEmitter() {
   initial_velocity_ = glm::vec3(0.0f, -10.0f, 0.0f);
 }
 
-void ThrustParticleEmitter::Spawn(float spawn_time) {
-  auto* particle = new Particle();
+void ThrustParticleEmitter::Spawn(int num_particles) {
+  auto batch = particle_system_.AddParticles(num_particles);
 
-  particle->lifespan_ += ofRandom(-0.5f, 0.5f);
+  random_.FillUniform(batch.lifespans_, batch.num_particles_,
+                      particle_lifespan_ - 0.5f, particle_lifespan_ + 0.5f);
+  random_.FillUniform(batch.radii_, batch.num_particles_,
+                      particle_radius_ - 0.05f, particle_radius_ + 0.05f);
 
-  particle->radius_ = 0.1f;
-  particle->radius_ += ofRandom(-0.05f, 0.05f);
-
-  // randomize position based on a circle's coordinates
-  auto initial_position = position_;
+  // randomize position within a horizontal circle
   const auto circle_radius = 0.5f;
-  const auto random_radius = circle_radius * sqrt(ofRandom(1.0f));
-
-  auto x = ofRandom(-1.0f, 1.0f);
-  auto z = ofRandom(-1.0f, 1.0f);
-
-  // normalize
-  x *= 1 / sqrt(x * x + z * z);
-  z *= 1 / sqrt(x * x + z * z);
-
-  // grow points based on circle's radius
-  x *= random_radius;
-  z *= random_radius;
+  random_.FillInDisc(batch.positions_, batch.num_particles_, circle_radius);
 
-  initial_position.x += x;
-  initial_position.z += z;
-
-  particle->position_ = initial_position;
-
-  particle->velocity_ = initial_velocity_;
+  for (auto i = 0; i < batch.num_particles_; i++) {
+    batch.positions_[i] += position_;
+  }
 
-  particle_system_.AddParticle(particle);
+  std::fill(batch.velocities_, batch.velocities_ + batch.num_particles_,
+            initial_velocity_);
 }
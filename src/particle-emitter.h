@@ -7,13 +7,14 @@
 #pragma once
 
 #include "particle-system.h"
+#include "random-stream.h"
 
 class ParticleEmitter {
  public:
   void Draw() const;
-  void Update();
+  void Update(const FrameTime& frame_time);
 
-  void Start();
+  void Start(float time);
   void Stop();
 
   bool fired_ = false;
@@ -21,13 +22,16 @@ class ParticleEmitter {
   bool started_ = false;
   int group_size_ = 10000;
   int rate_ = 1000;
-  float last_spawn_time_ = -1.0f;
+  float last_spawn_time_ = -1.0f;  // simulation time, seconds
+  float particle_lifespan_ = 0.5f;
+  float particle_radius_ = 0.1f;
   glm::vec3 initial_velocity_ = glm::vec3(0.0f);
   glm::vec3 position_ = glm::vec3(0.0f);
   ParticleSystem particle_system_;
+  RandomStream random_;
 
  private:
-  virtual void Spawn(float spawn_time);
+  virtual void Spawn(int num_particles);
 };
 
 class ThrustParticleEmitter : public ParticleEmitter {
@@ -35,5 +39,5 @@ class ThrustParticleEmitter : public ParticleEmitter {
   ThrustParticleEmitter();
 
  private:
-  void Spawn(float spawn_time) override;
+  void Spawn(int num_particles) override;
 };
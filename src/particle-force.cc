@@ -3,13 +3,10 @@
 //-Gravity Force Implementation---------------------------------
 GravityForce::GravityForce(const glm::vec3& gravity) : gravity_{gravity} {}
 
-void GravityForce::Update(Particle* particle) {
-  if (particle == nullptr) {
-    cerr << "GravityForce::Update() argument is null" << endl;
-    return;
+void GravityForce::Update(glm::vec3* positional_forces, int num_particles) {
+  for (auto i = 0; i < num_particles; i++) {
+    positional_forces[i] += gravity_;
   }
-
-  particle->positional_forces_ += gravity_;
 }
 
 //-TurbulenceForce Implementation-------------------------------
@@ -17,17 +14,23 @@ TurbulenceForce::TurbulenceForce(const glm::vec3& min_turbulence,
                                  const glm::vec3& max_turbulence)
     : min_turbulence_{min_turbulence}, max_turbulence_{max_turbulence} {}
 
-void TurbulenceForce::Update(Particle* particle) {
-  particle->positional_forces_.x += ofRandom(min_turbulence_.x, max_turbulence_.x);
-  particle->positional_forces_.y += ofRandom(min_turbulence_.y, max_turbulence_.y);
-  particle->positional_forces_.z += ofRandom(min_turbulence_.z, max_turbulence_.z);
+void TurbulenceForce::Update(glm::vec3* positional_forces,
+                             int num_particles) {
+  for (auto i = 0; i < num_particles; i++) {
+    positional_forces[i] += random_.Uniform(min_turbulence_, max_turbulence_);
+  }
 }
 
 XZTurbulenceForce::XZTurbulenceForce(const glm::vec3& min_turbulence,
                                      const glm::vec3& max_turbulence)
     : TurbulenceForce(min_turbulence, max_turbulence) {}
 
-void XZTurbulenceForce::Update(Particle* particle) {
-  particle->positional_forces_.x += ofRandom(min_turbulence_.x, max_turbulence_.x);
-  particle->positional_forces_.z += ofRandom(min_turbulence_.z, max_turbulence_.z);
+void XZTurbulenceForce::Update(glm::vec3* positional_forces,
+                               int num_particles) {
+  for (auto i = 0; i < num_particles; i++) {
+    positional_forces[i].x +=
+        random_.Uniform(min_turbulence_.x, max_turbulence_.x);
+    positional_forces[i].z +=
+        random_.Uniform(min_turbulence_.z, max_turbulence_.z);
+  }
 }
@@ -2,23 +2,35 @@
  * @class ParticleForce
  * @brief Encapsulates a ParticleForce to be applied on Particles in a
  * ParticleSystem
+ * @details A ParticleForce is applied to a whole span of Particles' force
+ * accumulators per call. Forces that are the same for every Particle also
+ * report their value, so a ParticleSystem can sum them into one add.
  * @author Patrick Silvestre
  */
 
 #pragma once
 
-#include "particle.h"
+#include "ofMain.h"
+#include "random-stream.h"
 
 class ParticleForce {
  public:
-  virtual void Update(Particle* particle) = 0;
+  virtual ~ParticleForce() = default;
+
+  virtual void Update(glm::vec3* positional_forces, int num_particles) = 0;
+
+  virtual bool IsConstant() const { return false; }
+  virtual glm::vec3 GetConstantForce() const { return glm::vec3(0.0f); }
 };
 
 class GravityForce : public ParticleForce {
  public:
   GravityForce(const glm::vec3& gravity);
 
-  void Update(Particle* particle) override;
+  void Update(glm::vec3* positional_forces, int num_particles) override;
+
+  bool IsConstant() const override { return true; }
+  glm::vec3 GetConstantForce() const override { return gravity_; }
 
  private:
   glm::vec3 gravity_ = glm::vec3(0.0f, -0.1f, 0.0f);
@@ -29,7 +41,9 @@ class TurbulenceForce : public ParticleForce {
   TurbulenceForce(const glm::vec3& min_turbulence,
                   const glm::vec3& max_turbulence);
 
-  void Update(Particle* particle) override;
+  void Update(glm::vec3* positional_forces, int num_particles) override;
+
+  RandomStream random_;
 
  protected:
   glm::vec3 min_turbulence_ = glm::vec3(-0.1);
@@ -40,5 +54,5 @@ class XZTurbulenceForce : public TurbulenceForce {
  public:
   XZTurbulenceForce(const glm::vec3& min_turbulence,
                     const glm::vec3& max_turbulence);
-  void Update(Particle* particle) override;
+  void Update(glm::vec3* positional_forces, int num_particles) override;
 };
@@ -0,0 +1,130 @@
+#include "particle-renderer.h"
+
+/**
+ * @brief Loads the point sprite texture and shader; needs a GL context
+ * @param texture_path The path to the sprite image
+ * @param shader_path The path to the shader, without the .vert and .frag
+ * extensions
+ * @return Whether both loaded
+ */
+bool ParticleRenderer::Load(const string& texture_path,
+                            const string& shader_path) {
+  // point sprites are textured with normalized coordinates, so the texture
+  // cannot be a rectangle texture
+  const auto using_arb_tex = ofGetUsingArbTex();
+  ofDisableArbTex();
+  const auto texture_loaded = ofLoadImage(texture_, texture_path);
+  if (using_arb_tex) ofEnableArbTex();
+
+  return texture_loaded && shader_.load(shader_path);
+}
+
+/**
+ * @brief Draws every live Particle in a ParticleSystem as a point sprite
+ * @param particle_system The ParticleSystem to draw
+ * @param point_scale Pixels per world unit at a distance of one, from
+ * GetPointScale()
+ */
+void ParticleRenderer::Draw(const ParticleSystem& particle_system,
+                            float point_scale) {
+  if (particle_system.GetNumParticles() == 0) return;
+
+  auto& buffer = GetNextBuffer(particle_system.GetCapacity());
+
+  // orphan the buffer's old storage, which the GPU may still be drawing from,
+  // then pack straight into the fresh storage
+  buffer.setData(buffer_capacity_ * sizeof(ParticleVertex), nullptr,
+                 GL_STREAM_DRAW);
+  auto* vertices = buffer.map<ParticleVertex>(GL_WRITE_ONLY);
+
+  if (vertices == nullptr) {
+    cerr << "Particle vertex buffer could not be mapped" << endl;
+    return;
+  }
+
+  const auto num_vertices = Pack(particle_system, vertices, buffer_capacity_);
+  buffer.unmap();
+
+  const int stride = sizeof(ParticleVertex);
+  vertex_buffer_.setVertexBuffer(buffer, 3, stride,
+                                 offsetof(ParticleVertex, position_));
+  vertex_buffer_.setNormalBuffer(buffer, stride,
+                                 offsetof(ParticleVertex, size_));
+  vertex_buffer_.setColorBuffer(buffer, stride,
+                                offsetof(ParticleVertex, color_));
+
+  // sprites blend over each other, so they should not hide one another
+  glDepthMask(GL_FALSE);
+  ofEnablePointSprites();
+
+  shader_.begin();
+  shader_.setUniform1f("point_scale", point_scale);
+  texture_.bind();
+
+  vertex_buffer_.draw(GL_POINTS, 0, num_vertices);
+
+  texture_.unbind();
+  shader_.end();
+
+  ofDisablePointSprites();
+  glDepthMask(GL_TRUE);
+}
+
+/**
+ * @brief Packs a ParticleSystem's live Particles into vertices, one each
+ * @details Does not touch OpenGL, so vertices may be mapped buffer memory or
+ * any plain array.
+ * @param particle_system The ParticleSystem to pack
+ * @param vertices Where to write the vertices
+ * @param max_vertices How many vertices fit; any Particles beyond are dropped
+ * @return The number of vertices written
+ */
+int ParticleRenderer::Pack(const ParticleSystem& particle_system,
+                           ParticleVertex* vertices, int max_vertices) {
+  const auto num_vertices =
+      std::min(particle_system.GetNumParticles(), max_vertices);
+  const auto* positions = particle_system.get_positions();
+  const auto* radii = particle_system.get_radii();
+  const auto* colors = particle_system.get_colors();
+
+  for (auto i = 0; i < num_vertices; i++) {
+    auto& vertex = vertices[i];
+    vertex.position_ = positions[i];
+    vertex.size_ = glm::vec3(2.0f * radii[i], 0.0f, 0.0f);
+    vertex.color_ = ofFloatColor(colors[i]);
+  }
+
+  return num_vertices;
+}
+
+/**
+ * @brief Computes the scale that turns a sprite's world diameter into pixels
+ * @details The shader divides by each sprite's depth, so sprites shrink with
+ * distance like the spheres they stand in for.
+ * @param fov The camera's vertical field of view, in degrees
+ * @param viewport_height The viewport's height, in pixels
+ * @return Pixels per world unit at a distance of one
+ */
+float ParticleRenderer::GetPointScale(float fov, float viewport_height) {
+  return viewport_height / (2.0f * tan(glm::radians(fov) / 2.0f));
+}
+
+//-Private Methods----------------------------------------------
+
+ofBufferObject& ParticleRenderer::GetNextBuffer(int min_capacity) {
+  // every buffer is sized for the largest ParticleSystem drawn so far, so
+  // orphaning hands the driver the same size each time and it can recycle
+  buffer_capacity_ = std::max(buffer_capacity_, min_capacity);
+
+  auto& buffer = buffers_[next_buffer_];
+  auto& allocated_capacity = allocated_capacities_[next_buffer_];
+  next_buffer_ = (next_buffer_ + 1) % kNumBuffers;
+
+  // setData() and map() do nothing until allocate() has created the GL buffer
+  if (allocated_capacity < buffer_capacity_) {
+    buffer.allocate(buffer_capacity_ * sizeof(ParticleVertex), GL_STREAM_DRAW);
+    allocated_capacity = buffer_capacity_;
+  }
+
+  return buffer;
+}
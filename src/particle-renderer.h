@@ -0,0 +1,47 @@
+/**
+ * @class ParticleRenderer
+ * @brief Draws a ParticleSystem's Particles as textured point sprites, in one
+ * draw call
+ * @details Live Particles are packed straight into mapped vertex memory, taken
+ * in turn from a ring of three buffers that are each orphaned before being
+ * rewritten, so a frame never waits on the GPU still drawing an earlier one.
+ * Packing itself needs no OpenGL, so it can be checked headless.
+ * @author Patrick Silvestre
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "particle-system.h"
+
+// one point sprite, laid out as the vertex buffer expects it
+class ParticleVertex {
+ public:
+  glm::vec3 position_;
+  glm::vec3 size_;  // the shader reads the diameter from x, as a normal
+  ofFloatColor color_;
+};
+
+class ParticleRenderer {
+ public:
+  bool Load(const string& texture_path, const string& shader_path);
+  void Draw(const ParticleSystem& particle_system, float point_scale);
+
+  static int Pack(const ParticleSystem& particle_system,
+                  ParticleVertex* vertices, int max_vertices);
+  static float GetPointScale(float fov, float viewport_height);
+
+ private:
+  ofBufferObject& GetNextBuffer(int min_capacity);
+
+  static constexpr int kNumBuffers = 3;
+
+  int buffer_capacity_ = 0;  // in vertices, the same for every buffer
+  int next_buffer_ = 0;
+  // what each buffer was last allocated for, in vertices; 0 until first used
+  int allocated_capacities_[kNumBuffers] = {0, 0, 0};
+  ofBufferObject buffers_[kNumBuffers];
+  ofShader shader_;
+  ofTexture texture_;
+  ofVbo vertex_buffer_;
+};
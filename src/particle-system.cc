@@ -1,22 +1,126 @@
 #include "particle-system.h"
 
-void ParticleSystem::Update() {
-  if (particles_.empty()) {
-    return;
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARTICLE_SYSTEM_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+#ifdef PARTICLE_SYSTEM_SSE2
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float),
+              "glm::vec3 arrays must be tightly packed floats");
+
+// selects a's lanes where mask is set and b's elsewhere
+inline __m128 Select(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Integrates four consecutive Particles with the same arithmetic, in the same
+// order, as the scalar loop in ParticleSystem::Integrate(), so both give
+// identical results. Four glm::vec3s fill exactly three registers, laid out
+// x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3; component-wise work runs on them as
+// loaded, and only the terminal velocity test gathers each Particle's
+// components into one lane.
+void IntegrateFour(float* position, float* velocity, float* acceleration,
+                   float* positional_forces, __m128 time_step,
+                   __m128 terminal_velocity, __m128 velocity_damping,
+                   __m128 acceleration_damping) {
+  const __m128 v0 = _mm_loadu_ps(velocity);
+  const __m128 v1 = _mm_loadu_ps(velocity + 4);
+  const __m128 v2 = _mm_loadu_ps(velocity + 8);
+
+  const auto x = _mm_shuffle_ps(_mm_shuffle_ps(v0, v0, _MM_SHUFFLE(3, 0, 3, 0)),
+                                _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(1, 1, 2, 2)),
+                                _MM_SHUFFLE(2, 0, 1, 0));
+  const auto y = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 1, 1)),
+                                _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 2, 3, 3)),
+                                _MM_SHUFFLE(2, 0, 2, 0));
+  const auto z = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 1, 2, 2)),
+                                _mm_shuffle_ps(v2, v2, _MM_SHUFFLE(3, 3, 0, 0)),
+                                _MM_SHUFFLE(2, 0, 2, 0));
+
+  // glm::length() sums x * x + y * y first, then z * z
+  const auto speed = _mm_sqrt_ps(_mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+  const auto below_terminal = _mm_cmplt_ps(speed, terminal_velocity);
+
+  // spread each Particle's test back over its three components
+  const __m128 masks[3] = {
+      _mm_shuffle_ps(below_terminal, below_terminal, _MM_SHUFFLE(1, 0, 0, 0)),
+      _mm_shuffle_ps(below_terminal, below_terminal, _MM_SHUFFLE(2, 2, 1, 1)),
+      _mm_shuffle_ps(below_terminal, below_terminal, _MM_SHUFFLE(3, 3, 3, 2))};
+  const __m128 velocities[3] = {v0, v1, v2};
+
+  for (auto k = 0; k < 3; k++) {
+    const auto offset = 4 * k;
+    auto p = _mm_loadu_ps(position + offset);
+    auto v = velocities[k];
+    auto a = _mm_loadu_ps(acceleration + offset);
+
+    p = _mm_add_ps(p, _mm_mul_ps(v, time_step));
+    a = _mm_add_ps(a, _mm_loadu_ps(positional_forces + offset));
+    v = Select(masks[k], _mm_add_ps(v, _mm_mul_ps(a, time_step)), v);
+    v = _mm_mul_ps(v, velocity_damping);
+    a = _mm_mul_ps(a, acceleration_damping);
+
+    _mm_storeu_ps(position + offset, p);
+    _mm_storeu_ps(velocity + offset, v);
+    _mm_storeu_ps(acceleration + offset, a);
+    _mm_storeu_ps(positional_forces + offset, _mm_setzero_ps());
   }
+}
+#endif
+
+}  // namespace
+
+ParticleSystem::ParticleSystem(int capacity) {
+  capacity = std::max(capacity, 0);
 
-  for (auto& particle : particles_) {
-    particle->Update();
+  positions_.resize(capacity);
+  velocities_.resize(capacity);
+  accelerations_.resize(capacity);
+  positional_forces_.resize(capacity);
+  radii_.resize(capacity);
+  lifespans_.resize(capacity);
+  remaining_lives_.resize(capacity);
+  colors_.resize(capacity);
+}
+
+void ParticleSystem::Update(const FrameTime& frame_time) {
+  if (num_particles_ == 0) {
+    return;
   }
 
+  StartNewParticles();
+
+  // dead Particles are removed first, rather than faded and integrated for
+  // nothing; the survivors end up exactly as before
   DeleteDeadParticles();
-  Integrate();
+
+  // each Particle's fade and integration are independent of the others', so
+  // the live range can be split across threads without changing the result
+  if (thread_pool_ != nullptr) {
+    thread_pool_->ParallelFor(0, num_particles_, kChunkSize,
+                              [&](int begin, int end) {
+                                UpdateColors(begin, end);
+                                Integrate(frame_time.time_step_, begin, end);
+                              });
+  } else {
+    UpdateColors(0, num_particles_);
+    Integrate(frame_time.time_step_, 0, num_particles_);
+  }
+
+  // forces may draw from a RandomStream in Particle order, so they run on this
+  // thread to keep seeded runs reproducible
   UpdateForces();
 }
 
 void ParticleSystem::Draw() const {
-  for (const auto& particle : particles_) {
-    particle->Draw();
+  for (auto i = 0; i < num_particles_; i++) {
+    ofSetColor(colors_[i]);
+    ofDrawSphere(positions_[i], radii_[i]);
   }
 }
 
@@ -29,45 +133,157 @@ void ParticleSystem::AddForce(ParticleForce* particle_force) {
   forces_.push_back(particle_force);
 }
 
-void ParticleSystem::AddParticle(Particle* particle) {
-  if (particle == nullptr) {
-    cerr << "ParticleSystem::AddParticle() argument is null" << endl;
-    return;
-  }
+bool ParticleSystem::AddParticle(const glm::vec3& position,
+                                 const glm::vec3& velocity, float radius,
+                                 float lifespan) {
+  // a full ParticleSystem drops new Particles rather than growing
+  if (num_particles_ == GetCapacity()) return false;
+
+  const auto i = num_particles_++;
 
-  particles_.push_back(particle);
+  positions_[i] = position;
+  velocities_[i] = velocity;
+  accelerations_[i] = glm::vec3(0.0f);
+  positional_forces_[i] = glm::vec3(0.0f);
+  radii_[i] = radius;
+  lifespans_[i] = lifespan;
+  colors_[i] = ofColor::white;
+
+  return true;
 }
 
-void ParticleSystem::DeleteDeadParticles() {
-  auto iterator = particles_.begin();
+ParticleBatch ParticleSystem::AddParticles(int num_particles) {
+  // a full ParticleSystem drops the Particles that do not fit
+  num_particles =
+      std::max(std::min(num_particles, GetCapacity() - num_particles_), 0);
+
+  const auto first = num_particles_;
+  const auto last = first + num_particles;
+  num_particles_ = last;
+
+  std::fill(accelerations_.begin() + first, accelerations_.begin() + last,
+            glm::vec3(0.0f));
+  std::fill(positional_forces_.begin() + first,
+            positional_forces_.begin() + last, glm::vec3(0.0f));
+  std::fill(colors_.begin() + first, colors_.begin() + last, ofColor::white);
+
+  ParticleBatch batch;
+  batch.num_particles_ = num_particles;
+  batch.positions_ = positions_.data() + first;
+  batch.velocities_ = velocities_.data() + first;
+  batch.radii_ = radii_.data() + first;
+  batch.lifespans_ = lifespans_.data() + first;
 
-  while (iterator != particles_.end()) {
-    const Particle* particle = *iterator;
+  return batch;
+}
+
+void ParticleSystem::Clear() {
+  num_particles_ = 0;
+  num_started_ = 0;
+}
+
+void ParticleSystem::StartNewParticles() {
+  // lifespans are only known once the caller has filled in its batch
+  std::copy(lifespans_.begin() + num_started_,
+            lifespans_.begin() + num_particles_,
+            remaining_lives_.begin() + num_started_);
 
-    if (particle->lifespan_ > 0.0f &&
-        particle->GetAge() > particle->lifespan_) {
-      // free allocated memory
-      delete particle;
-      particle = nullptr;
+  num_started_ = num_particles_;
+}
+
+void ParticleSystem::DeleteDeadParticles() {
+  auto i = 0;
 
-      // remove from vector
-      iterator = particles_.erase(iterator);
+  // swap-and-pop: the last live Particle takes a dead one's place, and is
+  // checked in turn
+  while (i < num_particles_) {
+    if (lifespans_[i] > 0.0f && remaining_lives_[i] < 0.0f) {
+      MoveParticle(--num_particles_, i);
     } else {
-      ++iterator;
+      i++;
+    }
+  }
+
+  num_started_ = num_particles_;
+}
+
+void ParticleSystem::MoveParticle(int from, int to) {
+  if (from == to) return;
+
+  positions_[to] = positions_[from];
+  velocities_[to] = velocities_[from];
+  accelerations_[to] = accelerations_[from];
+  positional_forces_[to] = positional_forces_[from];
+  radii_[to] = radii_[from];
+  lifespans_[to] = lifespans_[from];
+  remaining_lives_[to] = remaining_lives_[from];
+  colors_[to] = colors_[from];
+}
+
+void ParticleSystem::Integrate(float time_step, int begin, int end) {
+  auto i = begin;
+
+#ifdef PARTICLE_SYSTEM_SSE2
+  const auto time_step_4 = _mm_set1_ps(time_step);
+  const auto terminal_velocity_4 = _mm_set1_ps(terminal_velocity_);
+  const auto velocity_damping_4 = _mm_set1_ps(velocity_damping_);
+  const auto acceleration_damping_4 = _mm_set1_ps(acceleration_damping_);
+
+  for (; i + 4 <= end; i += 4) {
+    IntegrateFour(&positions_[i].x, &velocities_[i].x, &accelerations_[i].x,
+                  &positional_forces_[i].x, time_step_4, terminal_velocity_4,
+                  velocity_damping_4, acceleration_damping_4);
+  }
+#endif
+
+  // same arithmetic as Particle::IntegratePosition(); sparks never rotate
+  for (; i < end; i++) {
+    positions_[i] += velocities_[i] * time_step;
+    accelerations_[i] += positional_forces_[i];
+
+    if (glm::length(velocities_[i]) < terminal_velocity_) {
+      velocities_[i] += accelerations_[i] * time_step;
     }
+
+    velocities_[i] *= velocity_damping_;
+    accelerations_[i] *= acceleration_damping_;
+
+    positional_forces_[i] = glm::vec3(0.0f);
+  }
+
+  for (i = begin; i < end; i++) {
+    remaining_lives_[i] -= time_step;
   }
 }
 
-void ParticleSystem::Integrate() {
-  for (auto& particle : particles_) {
-    particle->Integrate();
+void ParticleSystem::UpdateColors(int begin, int end) {
+  // fade each Particle from white to red over its lifespan
+  for (auto i = begin; i < end; i++) {
+    const auto age = lifespans_[i] - remaining_lives_[i];
+    const auto fade = ofMap(age, 0, lifespans_[i], 255, 0);
+    colors_[i] = ofColor(255, fade, fade, fade);
   }
 }
 
 void ParticleSystem::UpdateForces() {
-  for (auto& particle : particles_) {
-    for (auto& force : forces_) {
-      force->Update(particle);
+  if (forces_.empty()) return;
+
+  // constant forces are summed, then added to every Particle in one pass
+  auto constant_force = glm::vec3(0.0f);
+  auto has_constant_force = false;
+
+  for (auto& force : forces_) {
+    if (force->IsConstant()) {
+      constant_force += force->GetConstantForce();
+      has_constant_force = true;
+    } else {
+      force->Update(positional_forces_.data(), num_particles_);
     }
   }
+
+  if (!has_constant_force) return;
+
+  for (auto i = 0; i < num_particles_; i++) {
+    positional_forces_[i] += constant_force;
+  }
 }
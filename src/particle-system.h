@@ -2,27 +2,87 @@
  * @class ParticleSystem
  * @brief Encapsulates a collection of Particles and the ParticleForces applied
  * on them
+ * @details Particles are stored as a structure of arrays, one array per
+ * attribute, packed densely so each pass streams through only the attributes
+ * it needs. The arrays are allocated once, at a fixed capacity, and dead
+ * Particles are replaced by the last live one, so neither spawning nor expiring
+ * allocates and the order of Particles is not preserved.
  * @author Patrick Silvestre
  */
 
 #pragma once
 
 #include "particle-force.h"
-#include "particle.h"
+#include "simulation-clock.h"
+#include "thread-pool.h"
+
+// the initial state of Particles just added by ParticleSystem::AddParticles(),
+// for the caller to fill in
+class ParticleBatch {
+ public:
+  int num_particles_ = 0;
+  glm::vec3* positions_ = nullptr;
+  glm::vec3* velocities_ = nullptr;
+  float* radii_ = nullptr;
+  float* lifespans_ = nullptr;
+};
 
 class ParticleSystem {
  public:
-  void Update();
+  explicit ParticleSystem(int capacity = kDefaultCapacity);
+
+  void Update(const FrameTime& frame_time);
   void Draw() const;
 
   void AddForce(ParticleForce* particle_force);
-  void AddParticle(Particle* particle);
+  bool AddParticle(const glm::vec3& position, const glm::vec3& velocity,
+                   float radius, float lifespan);
+  ParticleBatch AddParticles(int num_particles);
+  void Clear();
+
+  // updates are split across thread_pool's workers; nullptr updates serially
+  void set_thread_pool(ThreadPool* thread_pool) { thread_pool_ = thread_pool; }
+
+  int GetCapacity() const { return static_cast<int>(positions_.size()); }
+  int GetNumParticles() const { return num_particles_; }
+
+  // each points to GetNumParticles() live values
+  const glm::vec3* get_positions() const { return positions_.data(); }
+  const float* get_radii() const { return radii_.data(); }
+  const ofColor* get_colors() const { return colors_.data(); }
+
+  // enough for an explosion, or a second of thrust
+  static constexpr int kDefaultCapacity = 16384;
+
+  // Particles per parallel chunk; a multiple of 4 keeps every chunk's
+  // integration on the SSE path
+  static constexpr int kChunkSize = 1024;
+
+  // shared by every Particle in this ParticleSystem
+  float acceleration_damping_ = 0.99f;
+  float terminal_velocity_ = 5.0f;
+  float velocity_damping_ = 0.99f;
 
-  vector<Particle*> particles_;
   vector<ParticleForce*> forces_;
 
  private:
+  void StartNewParticles();
   void DeleteDeadParticles();
-  void Integrate();
+  void MoveParticle(int from, int to);
+  void Integrate(float time_step, int begin, int end);
+  void UpdateColors(int begin, int end);
   void UpdateForces();
+
+  vector<glm::vec3> positions_;
+  vector<glm::vec3> velocities_;
+  vector<glm::vec3> accelerations_;
+  vector<glm::vec3> positional_forces_;
+  vector<float> radii_;
+  vector<float> lifespans_;  // non-positive lifespans never expire
+  vector<float> remaining_lives_;  // counts down from the lifespan
+  vector<ofColor> colors_;
+
+  int num_particles_ = 0;
+  int num_started_ = 0;  // Particles past this were added since the last step
+  ThreadPool* thread_pool_ = nullptr;
 };
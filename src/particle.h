@@ -11,11 +11,9 @@
 
 class Particle {
  public:
-  void Update();
   virtual void Draw() const;
 
-  void Integrate();
-  float GetAge() const;
+  void Integrate(float time_step);
 
   float acceleration_damping_ = 0.99f;
   float angular_acceleration_ = 0.0f;
@@ -28,7 +26,6 @@ class Particle {
   float orientation_ = 0.0f;  // degrees
   float radius_ = 0.1f;
   float rotational_forces_ = 0.0f;
-  float spawn_time_ = ofGetElapsedTimef();
   float terminal_angular_velocity_ = 15.0f;
   float terminal_velocity_ = 5.0f;
   float velocity_damping_ = 0.99f;
@@ -42,6 +39,6 @@ class Particle {
   ofColor color_ = ofColor::red;
 
  private:
-  void IntegratePosition();
-  void IntegrateRotation();
+  void IntegratePosition(float time_step);
+  void IntegrateRotation(float time_step);
 };
@@ -0,0 +1,153 @@
+#include "random-stream.h"
+
+namespace {
+
+inline uint32_t RotateLeft(uint32_t value, int bits) {
+  return (value << bits) | (value >> (32 - bits));
+}
+
+// SplitMix64, used to spread a seed over the generator's whole state
+inline uint64_t SplitMix64(uint64_t& state) {
+  auto z = (state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+}  // namespace
+
+/**
+ * @brief Creates a RandomStream
+ * @param seed The seed shared by every stream of one run
+ * @param stream Which of the seed's independent streams to produce
+ */
+RandomStream::RandomStream(uint64_t seed, uint64_t stream) {
+  Seed(seed, stream);
+}
+
+/**
+ * @brief Restarts this RandomStream
+ * @param seed The seed shared by every stream of one run
+ * @param stream Which of the seed's independent streams to produce
+ */
+void RandomStream::Seed(uint64_t seed, uint64_t stream) {
+  auto mix = seed;
+  mix ^= SplitMix64(stream);
+
+  const auto low = SplitMix64(mix);
+  const auto high = SplitMix64(mix);
+
+  state_[0] = static_cast<uint32_t>(low);
+  state_[1] = static_cast<uint32_t>(low >> 32);
+  state_[2] = static_cast<uint32_t>(high);
+  state_[3] = static_cast<uint32_t>(high >> 32);
+
+  // the one state xoshiro can never leave
+  if ((state_[0] | state_[1] | state_[2] | state_[3]) == 0) state_[0] = 1;
+}
+
+/**
+ * @return A uniformly distributed 32-bit value
+ */
+uint32_t RandomStream::NextUint() {
+  const auto result = RotateLeft(state_[1] * 5, 7) * 9;
+  const auto t = state_[1] << 9;
+
+  state_[2] ^= state_[0];
+  state_[3] ^= state_[1];
+  state_[1] ^= state_[2];
+  state_[0] ^= state_[3];
+  state_[2] ^= t;
+  state_[3] = RotateLeft(state_[3], 11);
+
+  return result;
+}
+
+/**
+ * @return A uniformly distributed value in [0, 1)
+ */
+float RandomStream::NextFloat() {
+  // the top 24 bits fill a float's mantissa exactly
+  return (NextUint() >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @return A uniformly distributed value in [min, max)
+ */
+float RandomStream::Uniform(float min, float max) {
+  return min + (max - min) * NextFloat();
+}
+
+/**
+ * @return A vector whose components are each uniformly distributed between
+ * min's and max's
+ */
+glm::vec3 RandomStream::Uniform(const glm::vec3& min, const glm::vec3& max) {
+  const auto x = Uniform(min.x, max.x);
+  const auto y = Uniform(min.y, max.y);
+  const auto z = Uniform(min.z, max.z);
+  return glm::vec3(x, y, z);
+}
+
+/**
+ * @return A unit vector pointing in a uniformly distributed direction
+ */
+glm::vec3 RandomStream::Direction() {
+  // rejection sampling from the enclosing cube, skipping points too close to
+  // the centre to normalize accurately
+  while (true) {
+    const auto x = Uniform(-1.0f, 1.0f);
+    const auto y = Uniform(-1.0f, 1.0f);
+    const auto z = Uniform(-1.0f, 1.0f);
+    const auto length_squared = x * x + y * y + z * z;
+
+    if (length_squared <= 1.0f && length_squared > 1e-6f) {
+      return glm::vec3(x, y, z) / sqrt(length_squared);
+    }
+  }
+}
+
+/**
+ * @return A point uniformly distributed inside a disc about the origin, in the
+ * XZ plane
+ */
+glm::vec3 RandomStream::InDisc(float radius) {
+  // rejection sampling from the enclosing square keeps about 79% of tries
+  while (true) {
+    const auto x = Uniform(-1.0f, 1.0f);
+    const auto z = Uniform(-1.0f, 1.0f);
+
+    if (x * x + z * z <= 1.0f) return glm::vec3(x, 0.0f, z) * radius;
+  }
+}
+
+/**
+ * @brief Fills values with values uniformly distributed in [min, max)
+ */
+void RandomStream::FillUniform(float* values, int count, float min,
+                               float max) {
+  for (auto i = 0; i < count; i++) {
+    values[i] = Uniform(min, max);
+  }
+}
+
+/**
+ * @brief Fills values with vectors whose components are each uniformly
+ * distributed between min's and max's
+ */
+void RandomStream::FillUniform(glm::vec3* values, int count,
+                               const glm::vec3& min, const glm::vec3& max) {
+  for (auto i = 0; i < count; i++) {
+    values[i] = Uniform(min, max);
+  }
+}
+
+/**
+ * @brief Fills points with points uniformly distributed inside a disc about
+ * the origin, in the XZ plane
+ */
+void RandomStream::FillInDisc(glm::vec3* points, int count, float radius) {
+  for (auto i = 0; i < count; i++) {
+    points[i] = InDisc(radius);
+  }
+}
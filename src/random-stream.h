@@ -0,0 +1,38 @@
+/**
+ * @class RandomStream
+ * @brief A small, fast, seedable pseudorandom number generator
+ * (xoshiro128**), with bulk sampling of vectors and points
+ * @details Each emitter, force or thread owns its own RandomStream, so nothing
+ * is shared between threads and a run can be repeated exactly from its seed.
+ * Streams created from the same seed but different stream numbers are
+ * independent.
+ * @author Patrick Silvestre
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "ofMain.h"
+
+class RandomStream {
+ public:
+  explicit RandomStream(uint64_t seed = 0, uint64_t stream = 0);
+
+  void Seed(uint64_t seed, uint64_t stream = 0);
+
+  uint32_t NextUint();
+  float NextFloat();
+  float Uniform(float min, float max);
+  glm::vec3 Uniform(const glm::vec3& min, const glm::vec3& max);
+  glm::vec3 Direction();
+  glm::vec3 InDisc(float radius);
+
+  void FillUniform(float* values, int count, float min, float max);
+  void FillUniform(glm::vec3* values, int count, const glm::vec3& min,
+                   const glm::vec3& max);
+  void FillInDisc(glm::vec3* points, int count, float radius);
+
+ private:
+  uint32_t state_[4];
+};
@@ -1,5 +1,7 @@
 #include "ray.h"
 
+#include "glm/glm.hpp"
+
 /**
  * @brief Creates a ray
  * @param origin The origin of the ray
@@ -13,3 +15,50 @@ Ray::Ray(const glm::vec3& origin, const glm::vec3& direction)
   sign_[1] = inverse_direction_.y < 0;
   sign_[2] = inverse_direction_.z < 0;
 }
+
+/**
+ * @brief Determines if this ray intersects a triangle
+ * @details Uses the Moller-Trumbore algorithm, as described in Tomas Moller
+ * and Ben Trumbore "Fast, Minimum Storage Ray/Triangle Intersection" Journal
+ * of graphics tools, 2(1):21-28, 1997. Both faces of the triangle are hit.
+ * @param v0 The triangle's first vertex
+ * @param v1 The triangle's second vertex
+ * @param v2 The triangle's third vertex
+ * @param distance (SIDE EFFECT RETURN VALUE) The distance along this ray to
+ * the hit, in units of direction_
+ * @param barycentric (SIDE EFFECT RETURN VALUE) The hit's barycentric
+ * coordinates relative to v1 and v2
+ * @return True if the ray hits the triangle in front of its origin, false
+ * otherwise
+ */
+bool Ray::Intersect(const glm::vec3& v0, const glm::vec3& v1,
+                    const glm::vec3& v2, float& distance,
+                    glm::vec2& barycentric) const {
+  const auto edge1 = v1 - v0;
+  const auto edge2 = v2 - v0;
+  const auto p = glm::cross(direction_, edge2);
+  const auto determinant = glm::dot(edge1, p);
+
+  // ray is parallel to the triangle's plane
+  if (determinant > -1e-8f && determinant < 1e-8f) return false;
+
+  const auto inverse_determinant = 1.0f / determinant;
+  const auto t = origin_ - v0;
+  const auto u = glm::dot(t, p) * inverse_determinant;
+
+  if (u < 0.0f || u > 1.0f) return false;
+
+  const auto q = glm::cross(t, edge1);
+  const auto v = glm::dot(direction_, q) * inverse_determinant;
+
+  if (v < 0.0f || u + v > 1.0f) return false;
+
+  const auto hit_distance = glm::dot(edge2, q) * inverse_determinant;
+
+  if (hit_distance < 0.0f) return false;
+
+  distance = hit_distance;
+  barycentric = glm::vec2(u, v);
+
+  return true;
+}
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "glm/vec2.hpp"
 #include "glm/vec3.hpp"
 
 class Ray {
@@ -17,6 +18,9 @@ class Ray {
   Ray() = delete;
   Ray(const glm::vec3& origin, const glm::vec3& direction);
 
+  bool Intersect(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2,
+                 float& distance, glm::vec2& barycentric) const;
+
   int sign_[3] = {0, 0, 0};
   glm::vec3 direction_ = glm::vec3(0.0f);
   glm::vec3 inverse_direction_ = glm::vec3(0.0f);
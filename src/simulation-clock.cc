@@ -0,0 +1,64 @@
+#include "simulation-clock.h"
+
+#include <algorithm>
+
+/**
+ * @brief Creates a SimulationClock at time zero
+ * @param time_step The fixed duration of one simulation step, in seconds
+ * @param max_steps_per_frame The most steps one Advance() can make due, so a
+ * long stall does not make the simulation spend ever longer catching up
+ */
+SimulationClock::SimulationClock(float time_step, int max_steps_per_frame)
+    : time_step_{time_step},
+      max_accumulated_time_{time_step * std::max(max_steps_per_frame, 1)} {}
+
+/**
+ * @brief Adds real elapsed time to be consumed by Step()
+ * @param elapsed_time The time since the last call, in seconds
+ */
+void SimulationClock::Advance(float elapsed_time) {
+  accumulated_time_ =
+      std::min(accumulated_time_ + elapsed_time, max_accumulated_time_);
+}
+
+/**
+ * @brief Consumes one fixed step of accumulated time, if available
+ * @return Whether a step was taken, in which case the caller should advance the
+ * simulation by get_time_step()
+ */
+bool SimulationClock::Step() {
+  if (accumulated_time_ < time_step_) return false;
+
+  accumulated_time_ -= time_step_;
+  num_steps_++;
+
+  return true;
+}
+
+/**
+ * @brief Returns this SimulationClock to time zero
+ */
+void SimulationClock::Reset() {
+  accumulated_time_ = 0.0f;
+  num_steps_ = 0;
+}
+
+/**
+ * @return The simulation time after the steps taken so far, in seconds
+ * @details Computed from the step count rather than summed, so it does not
+ * drift over long runs.
+ */
+float SimulationClock::GetTime() const {
+  return static_cast<float>(num_steps_ * static_cast<double>(time_step_));
+}
+
+/**
+ * @return The step just taken, sampled once to be passed down to everything
+ * the step updates
+ */
+FrameTime SimulationClock::GetFrameTime() const {
+  FrameTime frame_time;
+  frame_time.time_ = GetTime();
+  frame_time.time_step_ = time_step_;
+  return frame_time;
+}
@@ -0,0 +1,36 @@
+/**
+ * @class SimulationClock
+ * @brief Turns variable frame times into a whole number of fixed simulation
+ * steps, so the simulation advances the same way at any frame rate
+ * @author Patrick Silvestre
+ */
+
+#pragma once
+
+// one simulation step: the time it ends at and its length, both in seconds
+class FrameTime {
+ public:
+  float time_ = 0.0f;
+  float time_step_ = 0.0f;
+};
+
+class SimulationClock {
+ public:
+  explicit SimulationClock(float time_step = 1.0f / 60.0f,
+                           int max_steps_per_frame = 8);
+
+  void Advance(float elapsed_time);
+  bool Step();
+  void Reset();
+
+  float GetTime() const;
+  FrameTime GetFrameTime() const;
+  float get_time_step() const { return time_step_; }
+  long long get_num_steps() const { return num_steps_; }
+
+ private:
+  float time_step_;
+  float max_accumulated_time_;
+  float accumulated_time_ = 0.0f;
+  long long num_steps_ = 0;
+};
@@ -0,0 +1,107 @@
+#include "thread-pool.h"
+
+namespace {
+
+// the ThreadPool and queue index of the worker running on this thread, if any
+thread_local const ThreadPool* current_thread_pool = nullptr;
+thread_local int current_worker = -1;
+
+}  // namespace
+
+/**
+ * @brief Creates a ThreadPool and starts its workers
+ * @param num_threads The desired number of worker threads, at least one
+ */
+ThreadPool::ThreadPool(int num_threads) {
+  if (num_threads < 1) num_threads = 1;
+
+  for (auto i = 0; i < num_threads; i++) {
+    queues_.push_back(std::make_unique<WorkQueue>());
+  }
+
+  for (auto i = 0; i < num_threads; i++) {
+    threads_.emplace_back(&ThreadPool::Work, this, i);
+  }
+}
+
+/**
+ * @brief Finishes all queued tasks, then joins this ThreadPool's workers
+ */
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+
+  condition_.notify_all();
+
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+//-Private Methods----------------------------------------------
+
+void ThreadPool::Push(std::function<void()> task) {
+  // a worker keeps its own tasks; anyone else deals them out in turn
+  const auto queue = current_thread_pool == this
+                         ? current_worker
+                         : static_cast<int>(next_queue_++ % queues_.size());
+
+  {
+    std::lock_guard<std::mutex> lock(queues_[queue]->mutex_);
+    queues_[queue]->tasks_.push_back(std::move(task));
+  }
+
+  {
+    // counted under mutex_ so a worker about to sleep cannot miss it
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_queued_++;
+  }
+
+  condition_.notify_one();
+}
+
+bool ThreadPool::Pop(int worker, std::function<void()>& task) {
+  const int num_queues = queues_.size();
+
+  // newest task from this worker's own queue, else the oldest from another's
+  for (auto i = 0; i < num_queues; i++) {
+    auto& queue = *queues_[(worker + i) % num_queues];
+    std::lock_guard<std::mutex> lock(queue.mutex_);
+
+    if (queue.tasks_.empty()) continue;
+
+    if (i == 0) {
+      task = std::move(queue.tasks_.back());
+      queue.tasks_.pop_back();
+    } else {
+      task = std::move(queue.tasks_.front());
+      queue.tasks_.pop_front();
+    }
+
+    num_queued_--;
+    return true;
+  }
+
+  return false;
+}
+
+void ThreadPool::Work(int worker) {
+  current_thread_pool = this;
+  current_worker = worker;
+
+  while (true) {
+    std::function<void()> task;
+
+    if (Pop(worker, task)) {
+      task();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this] { return stopping_ || num_queued_ > 0; });
+
+    if (stopping_ && num_queued_ <= 0) return;
+  }
+}
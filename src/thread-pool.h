@@ -0,0 +1,130 @@
+/**
+ * @class ThreadPool
+ * @brief A fixed set of worker threads that run submitted tasks
+ * @details Each worker has its own task queue. Tasks submitted from a worker go
+ * on that worker's queue, and are taken newest first; an idle worker steals the
+ * oldest task from another's queue.
+ * @author Patrick Silvestre
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+ public:
+  explicit ThreadPool(int num_threads = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  int get_num_threads() const { return static_cast<int>(threads_.size()); }
+
+  template <typename Task>
+  std::future<void> Submit(Task task);
+
+  template <typename Body>
+  void ParallelFor(int begin, int end, int grain_size, Body body);
+
+ private:
+  class WorkQueue {
+   public:
+    std::mutex mutex_;
+    std::deque<std::function<void()>> tasks_;
+  };
+
+  void Push(std::function<void()> task);
+  bool Pop(int worker, std::function<void()>& task);
+  void Work(int worker);
+
+  bool stopping_ = false;
+  std::atomic<int> num_queued_{0};
+  std::atomic<unsigned int> next_queue_{0};
+  std::condition_variable condition_;
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  std::vector<std::thread> threads_;
+};
+
+/**
+ * @brief Queues a task to be run on one of this ThreadPool's workers
+ * @param task The callable to run, taking no arguments
+ * @return A future that becomes ready once the task has finished
+ */
+template <typename Task>
+std::future<void> ThreadPool::Submit(Task task) {
+  auto packaged_task =
+      std::make_shared<std::packaged_task<void()>>(std::move(task));
+  auto future = packaged_task->get_future();
+
+  Push([packaged_task] { (*packaged_task)(); });
+
+  return future;
+}
+
+/**
+ * @brief Runs body over [begin, end) in chunks, spread across the calling
+ * thread and this ThreadPool's workers, and returns once every chunk is done
+ * @details Chunks always cover the same ranges, whichever thread runs them, so
+ * a body whose chunks are independent gives the same result every time. The
+ * calling thread works through chunks too, so this may be called from a
+ * worker.
+ * @param begin The first index
+ * @param end One past the last index
+ * @param grain_size The number of indices in each chunk but the last
+ * @param body The callable to run, taking a chunk's first and one past its last
+ * index
+ */
+template <typename Body>
+void ThreadPool::ParallelFor(int begin, int end, int grain_size, Body body) {
+  if (end <= begin) return;
+
+  grain_size = std::max(grain_size, 1);
+  const auto num_chunks = (end - begin + grain_size - 1) / grain_size;
+
+  if (num_chunks == 1) {
+    body(begin, end);
+    return;
+  }
+
+  // shared with the helpers, which may only start after every chunk is done
+  class Loop {
+   public:
+    std::atomic<int> next_chunk_{0};
+    std::atomic<int> num_done_{0};
+  };
+
+  auto loop = std::make_shared<Loop>();
+
+  auto run_chunks = [=] {
+    for (auto chunk = loop->next_chunk_++; chunk < num_chunks;
+         chunk = loop->next_chunk_++) {
+      const auto chunk_begin = begin + chunk * grain_size;
+      body(chunk_begin, std::min(chunk_begin + grain_size, end));
+      loop->num_done_++;
+    }
+  };
+
+  const auto num_helpers = std::min(get_num_threads(), num_chunks - 1);
+
+  for (auto i = 0; i < num_helpers; i++) {
+    Push(run_chunks);
+  }
+
+  run_chunks();
+
+  // chunks claimed by workers may still be running
+  while (loop->num_done_ < num_chunks) {
+    std::this_thread::yield();
+  }
+}